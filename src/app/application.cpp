@@ -1,38 +1,111 @@
 #include "application.h"
-#include <pqxx/connection.hxx>
+#include "tagged_uuid.h"
+#include <algorithm>
 
 
 namespace app {
-    Application::Application (std::string url_db) 
-        : db_{pqxx::connection{url_db}}
-        , use_cases_{db_.GetFactory()} {
+    namespace {
+        using ScoreId = util::TaggedUUID<struct ScoreTag>;
+    } // namespace
+
+    Application::Application (postgres::UnitOfWorkFactory& factory_uow, postgres::ScoreWriterSettings score_writer_settings,
+        size_t records_cache_pages) 
+        : use_cases_{factory_uow}
+        , leaderboard_{records_cache_pages}
+        , score_writer_{use_cases_, score_writer_settings, [this](const std::vector<DTO::Score>& scores) {
+            for (const auto& score : scores) {
+                leaderboard_.Add(score);
+            }
+        }} {
+        published_tokens_.fill(std::make_shared<const TokenShard>());
+        if (leaderboard_.GetCapacity() > 0) {
+            leaderboard_.Seed(use_cases_.GetScores(static_cast<int>(leaderboard_.GetCapacity()), 0));
+        }
     }
 
     std::pair<Token, uint64_t> Application::AddPlayer(model::GameSession& session, model::Dog& dog) {
+        std::lock_guard<std::mutex> lock(mtx_);
         ++counter_player_id_;
         auto& player = players_.Add(session, dog, counter_player_id_);
         auto token = tokens_.AddPlayer(player);
+        auto& state = AddSessionPlayer(player);
+        PublishToken(*tokens_.FindTokenByPlayer(&player), TokenEntry{&state, dog.GetId()});
         return {token, counter_player_id_};
     }
 
     Player* Application::FindByDogIdAndMapId(const model::Dog::Id& dog_id, const model::Map::Id& map_id){
+        std::lock_guard<std::mutex> lock(mtx_);
         return players_.FindByDogIdAndMapId(dog_id, map_id);
     }
 
-    Player* Application::FindPlayerByToken(const Token& token) const{
+    Player* Application::FindPlayerByToken(TokenKey token) const{
+        std::lock_guard<std::mutex> lock(mtx_);
         return tokens_.FindPlayerByToken(token);
     }
 
-    std::vector<Player*> Application::GetPlayersInSession(const model::GameSession* session){
-        return players_.GetPlayersInSession(session);
+    model::GameSession* Application::FindSessionByToken(TokenKey token) const {
+        auto entry = FindTokenEntry(token);
+        return entry.has_value() ? entry->state->session : nullptr;
     }
 
-    uint64_t Application::GetCounterPlayerId() const {
-        return counter_player_id_;
+    std::optional<Application::SessionView> Application::FindSessionViewByToken(TokenKey token) const {
+        auto entry = FindTokenEntry(token);
+        if (!entry.has_value()) {
+            return std::nullopt;
+        }
+
+        return MakeSessionView(*entry->state);
     }
 
-    const std::unordered_map<Token, Player*>& Application::GetTokensPlayers() const {
-        return tokens_.GetTokensPlayers();
+    Application::SessionView Application::GetSessionView(const model::GameSession* session) const {
+        const SessionPlayersState* state = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (auto it = session_players_.find(session); it != session_players_.end()) {
+                state = &it->second;
+            }
+        }
+
+        // В сессию ещё никто не входил
+        if (state == nullptr) {
+            static const PublishedPlayers empty;
+            return SessionView{
+                .session = session,
+                .snapshot = session->GetSnapshot(),
+                .players = empty.players,
+                .departed = empty.departed
+            };
+        }
+
+        // Состояние сессии не удаляется, а списки читаются атомарно, поэтому мьютекс уже не нужен
+        return MakeSessionView(*state);
+    }
+
+    bool Application::PushPlayerAction(TokenKey token, std::string_view dir) {
+        auto entry = FindTokenEntry(token);
+        if (!entry.has_value()) {
+            return false;
+        }
+
+        // Если собака успеет уйти из игры, тик просто пропустит команду: id собак не переиспользуются
+        entry->state->session->PushAction(model::MakeDogAction(*entry->dog_id, dir));
+        return true;
+    }
+
+    std::vector<std::pair<Token, const Player*>> Application::GetTokensPlayersInSession(const model::GameSession* session) const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::vector<std::pair<Token, const Player*>> result;
+        players_.ForEachInSession(session, [this, &result](const Player& player) {
+            if (auto token = tokens_.FindTokenByPlayer(&player)) {
+                result.emplace_back(token->ToString(), &player);
+            }
+        });
+        return result;
+    }
+
+    uint64_t Application::GetCounterPlayerId() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return counter_player_id_;
     }
 
     void Application::ExitPlayer(const std::vector<DTO::ExitPlayer>& exit_players) {
@@ -44,15 +117,31 @@ namespace app {
         }
     }
 
+    // Первые страницы отдаются из памяти. Остальные читаются из хранилища
+    // и не блокируют игроков и запись рекордов
     std::vector<DTO::Score> Application::GetScores(int limit, int offset) const {
-        std::lock_guard<std::mutex> lock(mtx_);
+        if (auto page = leaderboard_.GetPage(limit, offset)) {
+            return std::move(*page);
+        }
         return use_cases_.GetScores(limit, offset);
     }
 
+    std::vector<DTO::Score> Application::GetScoresAfter(const DTO::Score& after, int limit) const {
+        if (auto page = leaderboard_.GetPageAfter(after, limit)) {
+            return std::move(*page);
+        }
+        return use_cases_.GetScoresAfter(after, limit);
+    }
+
     void Application::Restore(const std::unordered_map<Token, Player>& token_to_player, uint64_t next_player_id) {
+        std::lock_guard<std::mutex> lock(mtx_);
         for(const auto& [token, player] : token_to_player) {
             app::Player& ref_player = players_.Add(player);
             tokens_.AddPlayer(token, ref_player);
+            auto& state = AddSessionPlayer(ref_player);
+            if (auto key = tokens_.FindTokenByPlayer(&ref_player)) {
+                PublishToken(*key, TokenEntry{&state, ref_player.GetDog().GetId()});
+            }
         }
         counter_player_id_ = next_player_id;
     }
@@ -72,13 +161,89 @@ namespace app {
         DTO::Score score {
             .name = dog.GetName(),
             .score = dog.GetScore(),
-            .play_time_ms = dog.GetPlayTime()
+            .play_time_ms = dog.GetPlayTime(),
+            .id = ScoreId::New().ToString()
         };
 
+        RemoveSessionPlayer(session, dog_id);
+        if (auto token = tokens_.FindTokenByPlayer(player_ptr)) {
+            PublishToken(*token, std::nullopt);
+        }
         tokens_.DeleteToken(player_ptr);
         players_.DeletePlayer(dog_id, map_id);
         session->DeleteDog(dog_id);
 
-        use_cases_.AddScore(score);
+        // Запись в базу выполняется вне тика, в потоке ScoreWriter. В таблицу рекордов
+        // рекорд попадает только после записи, поэтому кэш не расходится с базой
+        score_writer_.Push(std::move(score));
+    }
+
+    Application::SessionPlayersState& Application::AddSessionPlayer(Player& player) {
+        auto [it, inserted] = session_players_.try_emplace(player.GetSession());
+        auto& state = it->second;
+        if (inserted) {
+            state.session = player.GetSession();
+        }
+        const auto published = state.published;
+        std::atomic_store(&state.published, std::make_shared<const PublishedPlayers>(PublishedPlayers{
+            .players = published->players->Insert(PlayerView{
+                .id = player.GetId(),
+                .dog_id = player.GetDog().GetId(),
+                .name = player.GetName()
+            }),
+            .departed = published->departed
+        }));
+        return state;
+    }
+
+    void Application::RemoveSessionPlayer(const model::GameSession* session, model::Dog::Id dog_id) {
+        auto& state = session_players_.at(session);
+        const auto published = state.published;
+        const auto* player = published->players->Find(dog_id);
+        if (player == nullptr) {
+            return;
+        }
+
+        auto departed = published->departed->Insert(*player);
+        state.departed_order.push_back(dog_id);
+        if (state.departed_order.size() > DEPARTED_HISTORY_SIZE) {
+            departed = departed->Erase(state.departed_order.front());
+            state.departed_order.pop_front();
+        }
+        std::atomic_store(&state.published, std::make_shared<const PublishedPlayers>(PublishedPlayers{
+            .players = published->players->Erase(dog_id),
+            .departed = std::move(departed)
+        }));
+    }
+
+    // Снимок берётся раньше списков игроков: собака снимка уже есть в players или в departed
+    Application::SessionView Application::MakeSessionView(const SessionPlayersState& state) {
+        auto snapshot = state.session->GetSnapshot();
+        const auto published = std::atomic_load(&state.published);
+        return SessionView{
+            .session = state.session,
+            .snapshot = std::move(snapshot),
+            .players = published->players,
+            .departed = published->departed
+        };
+    }
+
+    std::optional<Application::TokenEntry> Application::FindTokenEntry(TokenKey token) const {
+        const auto shard = std::atomic_load(&published_tokens_[token.Hash() >> (64 - TOKEN_SHARD_BITS)]);
+        if (const auto* entry = shard->Find(token)) {
+            return *entry;
+        }
+        return std::nullopt;
+    }
+
+    void Application::PublishToken(TokenKey token, std::optional<TokenEntry> entry) {
+        auto& slot = published_tokens_[token.Hash() >> (64 - TOKEN_SHARD_BITS)];
+        auto shard = std::make_shared<TokenShard>(*std::atomic_load(&slot));
+        if (entry.has_value()) {
+            shard->Insert(token, *entry);
+        } else {
+            shard->Erase(token);
+        }
+        std::atomic_store(&slot, std::shared_ptr<const TokenShard>(std::move(shard)));
     }
 } //namespace app
\ No newline at end of file
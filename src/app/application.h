@@ -2,35 +2,113 @@
 #include "player.h"
 #include "players.h"
 #include "player_tokens.h"
+#include "leaderboard.h"
+#include "player_list.h"
 #include "use_cases_impl.h"
-#include "postgres.h"
+#include "unit_of_work.h"
+#include "score_writer.h"
+#include <array>
+#include <deque>
 #include <vector>
 #include <mutex>
+#include <string_view>
+#include <memory>
+#include <optional>
 
 namespace app {
+    /*
+     * Методы вызываются из strand разных игровых сессий,
+     * поэтому изменения игроков и токенов защищены мьютексом.
+     * Поиск по токену для чтения состояния и команд идёт без мьютекса,
+     * по опубликованному индексу токенов
+     */
     class Application {
     public:
-        explicit Application (std::string url_db);
+        using PlayerView = app::PlayerView;
+        // Неизменяемый список игроков сессии, при входе и выходе игроков публикуется новый
+        using SessionPlayers = PlayerList;
+
+        // Всё, что нужно для ответа на запрос чтения без захода в strand сессии
+        struct SessionView {
+            const model::GameSession* session = nullptr;
+            // Снимок берётся раньше списка игроков, поэтому у каждой собаки снимка
+            // игрок уже есть в players или в departed
+            std::shared_ptr<const model::SessionSnapshot> snapshot;
+            std::shared_ptr<const SessionPlayers> players;
+            // Последние вышедшие из сессии игроки, для ответов с изменениями состояния
+            std::shared_ptr<const SessionPlayers> departed;
+        };
+
+        // factory_uow - хранилище рекордов (PostgreSQL или локальный файл), должно пережить Application.
+        // records_cache_pages - сколько страниц /records отдаётся из памяти
+        Application (postgres::UnitOfWorkFactory& factory_uow, postgres::ScoreWriterSettings score_writer_settings,
+            size_t records_cache_pages);
         std::pair<Token, uint64_t> AddPlayer(model::GameSession& session, model::Dog& dog);
         Player* FindByDogIdAndMapId(const model::Dog::Id& dog_id, const model::Map::Id& map_id);
-        Player* FindPlayerByToken(const Token& token) const;
-        std::vector<Player*> GetPlayersInSession(const model::GameSession* session);
+        Player* FindPlayerByToken(TokenKey token) const;
+        // FindSessionByToken, FindSessionViewByToken и PushPlayerAction не берут мьютекс
+        model::GameSession* FindSessionByToken(TokenKey token) const;
+        std::optional<SessionView> FindSessionViewByToken(TokenKey token) const;
+        SessionView GetSessionView(const model::GameSession* session) const;
+        // Ставит команду в очередь сессии игрока. false, если токен не найден
+        bool PushPlayerAction(TokenKey token, std::string_view dir);
+        std::vector<std::pair<Token, const Player*>> GetTokensPlayersInSession(const model::GameSession* session) const;
         uint64_t GetCounterPlayerId() const;
-        const std::unordered_map<Token, Player*>& GetTokensPlayers() const;
 
         void ExitPlayer(const std::vector<DTO::ExitPlayer>& exit_players);
         std::vector<DTO::Score> GetScores(int limit, int offset) const;
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const;
 
         void Restore(const std::unordered_map<Token, Player>& token_to_player, uint64_t next_player_id);
     private:
-        postgres::DataBase db_;
+        // Хранилища допускают параллельные запросы, поэтому use_cases_ можно вызывать без mtx_
         postgres::UseCasesImpl use_cases_;
+        // Первые страницы рекордов, уже записанных в базу
+        Leaderboard leaderboard_;
+        // Рекорды пишутся из отдельного потока ScoreWriter. Он пополняет leaderboard_,
+        // поэтому объявлен после него и останавливается раньше
+        postgres::ScoreWriter score_writer_;
         mutable std::mutex mtx_;
         uint64_t counter_player_id_ = 0;
         Players players_;
         PlayerTokens tokens_;
+        // Списки публикуются парой, чтобы читатель видел согласованные players и departed
+        struct PublishedPlayers {
+            std::shared_ptr<const SessionPlayers> players = std::make_shared<const SessionPlayers>();
+            std::shared_ptr<const SessionPlayers> departed = std::make_shared<const SessionPlayers>();
+        };
+        struct SessionPlayersState {
+            model::GameSession* session = nullptr;
+            // Читается и заменяется через std::atomic_load/atomic_store
+            std::shared_ptr<const PublishedPlayers> published = std::make_shared<const PublishedPlayers>();
+            // Порядок выхода, по нему из departed вытесняются самые старые записи
+            std::deque<model::Dog::Id> departed_order;
+        };
+        // Узлы unordered_map не перемещаются, поэтому на состояния ссылается индекс токенов
+        std::unordered_map<const model::GameSession*, SessionPlayersState> session_players_;
+
+        // Всё, что нужно запросу по токену: сессия игрока и id его собаки
+        struct TokenEntry {
+            SessionPlayersState* state = nullptr;
+            model::Dog::Id dog_id{0};
+        };
+        using TokenShard = TokenTable<TokenEntry>;
+        static constexpr size_t TOKEN_SHARD_BITS = 6;
+        /*
+         * Неизменяемые шарды индекса токенов. Читаются через std::atomic_load без мьютекса,
+         * вход и выход игрока копируют под mtx_ только свой шард и публикуют его через atomic_store
+         */
+        std::array<std::shared_ptr<const TokenShard>, size_t{1} << TOKEN_SHARD_BITS> published_tokens_;
     private:
+        static constexpr size_t DEPARTED_HISTORY_SIZE = 1024;
+
         void ExitPlayer(const model::Dog::Id& dog_id, const model::Map::Id& map_id);
+        SessionPlayersState& AddSessionPlayer(Player& player);
+        void RemoveSessionPlayer(const model::GameSession* session, model::Dog::Id dog_id);
+        static SessionView MakeSessionView(const SessionPlayersState& state);
+        std::optional<TokenEntry> FindTokenEntry(TokenKey token) const;
+        // entry == nullopt удаляет токен из индекса
+        void PublishToken(TokenKey token, std::optional<TokenEntry> entry);
     };
 
 } //namespace app
\ No newline at end of file
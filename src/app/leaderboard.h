@@ -0,0 +1,102 @@
+#pragma once
+#include "data_transfer_object.h"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace app {
+    /*
+     * Первые capacity рекордов в порядке выдачи /records (DTO::ScoreOrder).
+     * Заполняется из базы при старте и дополняется каждым новым рекордом,
+     * поэтому страницы в пределах capacity отдаются без запроса к базе.
+     * Если в базе рекордов меньше capacity, в кэше лежат все рекорды и
+     * из памяти отдаётся любая страница
+     */
+    class Leaderboard {
+    public:
+        // Размер страницы /records, capacity кратна ему
+        static constexpr size_t PAGE_SIZE = 100;
+
+        explicit Leaderboard(size_t pages)
+            : capacity_{pages * PAGE_SIZE} {
+        }
+
+        size_t GetCapacity() const {
+            return capacity_;
+        }
+
+        // scores - первые capacity рекордов из базы в порядке выдачи
+        void Seed(std::vector<DTO::Score> scores) {
+            std::lock_guard lock{mtx_};
+            // Полный ответ базы значит, что за его пределами могут быть ещё рекорды
+            complete_ = scores.size() < capacity_;
+            scores_ = std::move(scores);
+            scores_.resize(std::min(scores_.size(), capacity_));
+        }
+
+        // Новый рекорд. Если он ниже последнего места в заполненном кэше, он не нужен
+        void Add(const DTO::Score& score) {
+            if (capacity_ == 0) {
+                return;
+            }
+
+            std::lock_guard lock{mtx_};
+            auto it = std::upper_bound(scores_.begin(), scores_.end(), score, DTO::ScoreOrder{});
+            if (scores_.size() == capacity_) {
+                if (it == scores_.end()) {
+                    complete_ = false;
+                    return;
+                }
+                scores_.pop_back();
+                complete_ = false;
+            }
+            scores_.insert(it, score);
+        }
+
+        // nullopt, если страница выходит за кэш и её нужно читать из базы
+        std::optional<std::vector<DTO::Score>> GetPage(int64_t limit, int64_t offset) const {
+            if (limit < 0 || offset < 0) {
+                return std::nullopt;
+            }
+
+            std::shared_lock lock{mtx_};
+            const auto size = static_cast<uint64_t>(scores_.size());
+            const auto begin = static_cast<uint64_t>(offset);
+            const auto end = begin + static_cast<uint64_t>(limit);
+            if (!complete_ && end > size) {
+                return std::nullopt;
+            }
+
+            std::vector<DTO::Score> page;
+            if (begin < size) {
+                page.assign(scores_.begin() + begin, scores_.begin() + std::min(end, size));
+            }
+            return page;
+        }
+
+        // Страница после рекорда after. nullopt, если она выходит за кэш
+        std::optional<std::vector<DTO::Score>> GetPageAfter(const DTO::Score& after, int64_t limit) const {
+            if (limit < 0) {
+                return std::nullopt;
+            }
+
+            std::shared_lock lock{mtx_};
+            auto begin = std::upper_bound(scores_.begin(), scores_.end(), after, DTO::ScoreOrder{});
+            const auto available = static_cast<uint64_t>(scores_.end() - begin);
+            if (!complete_ && static_cast<uint64_t>(limit) > available) {
+                return std::nullopt;
+            }
+
+            return std::vector<DTO::Score>(begin, begin + std::min(static_cast<uint64_t>(limit), available));
+        }
+    private:
+        const size_t capacity_;
+        mutable std::shared_mutex mtx_;
+        std::vector<DTO::Score> scores_;
+        // В кэше лежат все рекорды, какие есть в базе
+        bool complete_ = false;
+    };
+} // namespace app
@@ -0,0 +1,188 @@
+#pragma once
+#include "player.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace app {
+    struct PlayerView {
+        Player::Id id;
+        model::Dog::Id dog_id;
+        std::string name;
+    };
+
+    /*
+     * Неизменяемый список игроков сессии, упорядоченный по id собаки.
+     * Игроки хранятся блоками не больше MAX_CHUNK_SIZE. Insert и Erase
+     * возвращают новый список, который разделяет с исходным все блоки,
+     * кроме изменённого, поэтому вход и выход игрока копируют один блок
+     * и массив указателей на блоки, а не всех игроков. Поиск по id
+     * собаки - двоичный, сначала среди блоков, затем внутри блока
+     */
+    class PlayerList {
+        using Chunk = std::vector<PlayerView>;
+        using Chunks = std::vector<std::shared_ptr<const Chunk>>;
+    public:
+        static constexpr size_t MAX_CHUNK_SIZE = 64;
+
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = PlayerView;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const PlayerView*;
+            using reference = const PlayerView&;
+
+            Iterator() = default;
+            Iterator(Chunks::const_iterator chunk, size_t pos)
+                : chunk_{chunk}
+                , pos_{pos} {
+            }
+
+            reference operator*() const {
+                return (**chunk_)[pos_];
+            }
+
+            pointer operator->() const {
+                return &**this;
+            }
+
+            Iterator& operator++() {
+                if (++pos_ == (*chunk_)->size()) {
+                    ++chunk_;
+                    pos_ = 0;
+                }
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return chunk_ == other.chunk_ && pos_ == other.pos_;
+            }
+        private:
+            Chunks::const_iterator chunk_;
+            size_t pos_ = 0;
+        };
+
+        Iterator begin() const {
+            return {chunks_.begin(), 0};
+        }
+
+        Iterator end() const {
+            return {chunks_.end(), 0};
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        const PlayerView* Find(model::Dog::Id dog_id) const {
+            auto chunk = FindChunk(dog_id);
+            if (chunk == chunks_.end()) {
+                return nullptr;
+            }
+
+            auto it = LowerBound(**chunk, dog_id);
+            return it != (*chunk)->end() && it->dog_id == dog_id ? &*it : nullptr;
+        }
+
+        // Игрок с тем же id собаки заменяется
+        std::shared_ptr<const PlayerList> Insert(PlayerView player) const {
+            auto updated = std::make_shared<PlayerList>(*this);
+            auto& chunks = updated->chunks_;
+            auto chunk = chunks.begin() + (FindChunk(player.dog_id) - chunks_.begin());
+
+            // Игроки обычно входят по возрастанию id собаки, и новый игрок
+            // дописывается в конец: заполненный последний блок не делится, а начинается новый
+            if (chunk == chunks.end()) {
+                if (chunks.empty() || chunks.back()->size() == MAX_CHUNK_SIZE) {
+                    chunks.push_back(std::make_shared<const Chunk>(Chunk{std::move(player)}));
+                    ++updated->size_;
+                    return updated;
+                }
+                chunk = std::prev(chunks.end());
+            }
+
+            auto copy = std::make_shared<Chunk>(**chunk);
+            auto it = LowerBound(*copy, player.dog_id);
+            if (it != copy->end() && it->dog_id == player.dog_id) {
+                *it = std::move(player);
+                *chunk = std::move(copy);
+                return updated;
+            }
+
+            copy->insert(it, std::move(player));
+            ++updated->size_;
+            if (copy->size() <= MAX_CHUNK_SIZE) {
+                *chunk = std::move(copy);
+                return updated;
+            }
+
+            // Переполненный блок делится пополам
+            const auto middle = copy->begin() + copy->size() / 2;
+            auto tail = std::make_shared<const Chunk>(std::make_move_iterator(middle), std::make_move_iterator(copy->end()));
+            copy->erase(middle, copy->end());
+            *chunk = std::move(copy);
+            chunks.insert(std::next(chunk), std::move(tail));
+            return updated;
+        }
+
+        // nullptr, если игрока с такой собакой нет
+        std::shared_ptr<const PlayerList> Erase(model::Dog::Id dog_id) const {
+            auto found = FindChunk(dog_id);
+            if (found == chunks_.end()) {
+                return nullptr;
+            }
+            auto it = LowerBound(**found, dog_id);
+            if (it == (*found)->end() || it->dog_id != dog_id) {
+                return nullptr;
+            }
+
+            auto updated = std::make_shared<PlayerList>(*this);
+            auto chunk = updated->chunks_.begin() + (found - chunks_.begin());
+            --updated->size_;
+            if ((*chunk)->size() == 1) {
+                updated->chunks_.erase(chunk);
+                return updated;
+            }
+
+            auto copy = std::make_shared<Chunk>(**chunk);
+            copy->erase(copy->begin() + (it - (*found)->begin()));
+            *chunk = std::move(copy);
+            return updated;
+        }
+    private:
+        Chunks chunks_;
+        size_t size_ = 0;
+    private:
+        // Первый блок, последний игрок которого не меньше dog_id
+        Chunks::const_iterator FindChunk(model::Dog::Id dog_id) const {
+            return std::lower_bound(chunks_.begin(), chunks_.end(), dog_id, [](const auto& chunk, model::Dog::Id id) {
+                return *chunk->back().dog_id < *id;
+            });
+        }
+
+        static Chunk::const_iterator LowerBound(const Chunk& chunk, model::Dog::Id dog_id) {
+            return std::lower_bound(chunk.begin(), chunk.end(), dog_id, [](const PlayerView& player, model::Dog::Id id) {
+                return *player.dog_id < *id;
+            });
+        }
+
+        static Chunk::iterator LowerBound(Chunk& chunk, model::Dog::Id dog_id) {
+            return std::lower_bound(chunk.begin(), chunk.end(), dog_id, [](const PlayerView& player, model::Dog::Id id) {
+                return *player.dog_id < *id;
+            });
+        }
+    };
+} // namespace app
@@ -1,67 +1,61 @@
 #include "player_tokens.h"
 #include <cstdint>
+#include <stdexcept>
 
 
 namespace app {
-    
-    namespace detail {
-        std::string NumberToHexString(uint64_t num) {
-            static const std::string hex_chars = "0123456789ABCDEF";
-            std::string result(16, '0');  // 16 символов для 64 бит
-            
-            for (int i = 15; i >= 0; --i) {
-                if (num == 0) {
-                    break;
-                }
 
-                result[i] = hex_chars[num & 0xF];  // Младшие 4 бита
-                num >>= 4;  // Сдвигаем на 4 бита вправо
-            }
-            return result;
-        }
-    } //namespace detail 
-
-    Token PlayerTokens::GetToken() {
-        auto low = detail::NumberToHexString(static_cast<uint64_t>(gen_low_()));
-        auto high = detail::NumberToHexString(static_cast<uint64_t>(gen_high_()));
-        return high + low;
+    TokenKey PlayerTokens::GetToken() {
+        return TokenKey{
+            .high = static_cast<uint64_t>(gen_high_()),
+            .low = static_cast<uint64_t>(gen_low_())
+        };
     }    
 
     Token PlayerTokens::AddPlayer(Player& player) {
-        Token token = GetToken();
+        TokenKey token = GetToken();
         //Исключаем дубли токенов
-        while (token_to_player_.contains(token)) {
+        while (!token_to_player_.Insert(token, &player)) {
             token = GetToken();
         }
 
-        token_to_player_[token] = &player;
         player_to_token_[&player] = token;
-        return token;
+        return token.ToString();
     }
 
     Token PlayerTokens::AddPlayer(const Token& token, Player& player) {
-        auto [it_t, inserted_t] = token_to_player_.emplace(token, &player);
-        player_to_token_.emplace(&player, token);
+        auto key = TokenKey::Parse(token);
+        if (!key.has_value()) {
+            throw std::invalid_argument("Invalid token " + token);
+        }
+
+        if (token_to_player_.Insert(*key, &player)) {
+            player_to_token_.emplace(&player, *key);
+        }
 
-        return it_t->first;
+        return key->ToString();
     }
 
     void PlayerTokens::DeleteToken(const Player* player_ptr) {
         auto token = player_to_token_.at(player_ptr);
-        token_to_player_.erase(token);
+        token_to_player_.Erase(token);
         player_to_token_.erase(player_ptr);
     }
 
-    Player* PlayerTokens::FindPlayerByToken(const Token& token) const {
-        if (auto it = token_to_player_.find(token); it != token_to_player_.end()) {
-            return it->second;
+    Player* PlayerTokens::FindPlayerByToken(TokenKey token) const {
+        if (auto* player = token_to_player_.Find(token)) {
+            return *player;
         }
 
         return nullptr;
     }
 
-    const std::unordered_map<Token, Player*>& PlayerTokens::GetTokensPlayers() const {
-        return token_to_player_;
+    std::optional<TokenKey> PlayerTokens::FindTokenByPlayer(const Player* player) const {
+        if (auto it = player_to_token_.find(player); it != player_to_token_.end()) {
+            return it->second;
+        }
+
+        return std::nullopt;
     }
 
-} //namespace app
\ No newline at end of file
+} //namespace app
@@ -1,11 +1,14 @@
 #pragma once
+#include <optional>
 #include <string>
 #include <random>
 #include <unordered_map>
 #include "player.h"
+#include "token_table.h"
 
 
 namespace app {
+    // Токен в том виде, в котором его видит клиент: 32 шестнадцатеричные цифры
     using Token = std::string;
 
     class PlayerTokens {
@@ -13,14 +16,15 @@ namespace app {
         PlayerTokens() = default;
         
         Token AddPlayer(Player& player);
+        // Выбрасывает std::invalid_argument, если токен не из 32 шестнадцатеричных цифр
         Token AddPlayer(const Token& token, Player& player);
         void DeleteToken(const Player* player_ptr);
-        Player* FindPlayerByToken(const Token& token) const;
-        const std::unordered_map<Token, Player*>& GetTokensPlayers() const;
+        Player* FindPlayerByToken(TokenKey token) const;
+        std::optional<TokenKey> FindTokenByPlayer(const Player* player) const;
 
     private:
-        std::unordered_map<Token, Player*> token_to_player_;
-        std::unordered_map<const Player*, Token> player_to_token_;
+        TokenTable<Player*> token_to_player_;
+        std::unordered_map<const Player*, TokenKey> player_to_token_;
         std::random_device rd_;
         std::mt19937_64 gen_low_{[this] {
             std::uniform_int_distribution<std::mt19937_64::result_type> dist;
@@ -31,6 +35,6 @@ namespace app {
             return dist(rd_);
         }()};
     private:
-        Token GetToken();
+        TokenKey GetToken();
     };
-} //namespace app
\ No newline at end of file
+} //namespace app
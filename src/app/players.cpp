@@ -7,8 +7,11 @@ namespace app {
             .dog_id = dog.GetId()
         };
 
-        auto [it, inserted] = players_.try_emplace(player_key, session, dog, id, dog.GetName());
-        return it->second;
+        auto [it, inserted] = players_.try_emplace(player_key, Entry{Player{session, dog, id, dog.GetName()}});
+        if (inserted) {
+            AddToIndex(it->second);
+        }
+        return it->second.player;
     }
 
     Player& Players::Add(const Player& player) {
@@ -17,9 +20,12 @@ namespace app {
             .dog_id = player.GetDog().GetId()
         };
 
-        auto [it, insert] = players_.emplace(player_key, player);
+        auto [it, insert] = players_.emplace(player_key, Entry{player});
+        if (insert) {
+            AddToIndex(it->second);
+        }
 
-        return it->second;
+        return it->second.player;
     }
 
     void Players::DeletePlayer(const model::Dog::Id& dog_id, const model::Map::Id& map_id) {
@@ -27,7 +33,10 @@ namespace app {
             .map_id = map_id,
             .dog_id = dog_id
         };
-        players_.erase(pk);
+        if (auto it = players_.find(pk); it != players_.end()) {
+            RemoveFromIndex(it->second);
+            players_.erase(it);
+        }
     }
 
     Player* Players::FindByDogIdAndMapId(const model::Dog::Id& dog_id, const model::Map::Id& map_id) {
@@ -37,19 +46,31 @@ namespace app {
         };
 
         if (auto it = players_.find(player_key); it != players_.end()) {
-            return &it->second;
+            return &it->second.player;
         }
 
         return nullptr;
     }
 
-    std::vector<Player*> Players::GetPlayersInSession(const model::GameSession* session) {
-        std::vector<Player*> result;
-        for (auto& [key, player] : players_) {
-            if (player.GetSession() == session) {
-                result.push_back(&player);
-            }
+    void Players::AddToIndex(Entry& entry) {
+        auto& index = session_index_[entry.player.GetSession()];
+        entry.session_pos = index.size();
+        index.push_back(&entry);
+    }
+
+    void Players::RemoveFromIndex(const Entry& entry) {
+        auto it = session_index_.find(entry.player.GetSession());
+        if (it == session_index_.end()) {
+            return;
+        }
+
+        auto& index = it->second;
+        Entry* last = index.back();
+        index[entry.session_pos] = last;
+        last->session_pos = entry.session_pos;
+        index.pop_back();
+        if (index.empty()) {
+            session_index_.erase(it);
         }
-        return result;
     }
 } // namespace app
\ No newline at end of file
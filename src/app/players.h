@@ -3,6 +3,7 @@
 #include "model.h"
 #include "dog.h"
 #include <unordered_map>
+#include <vector>
 
 
 namespace app {
@@ -29,8 +30,29 @@ namespace app {
         Player& Add(const Player& player);
         void DeletePlayer(const model::Dog::Id& dog_id, const model::Map::Id& map_id);
         Player* FindByDogIdAndMapId(const model::Dog::Id& dog_id, const model::Map::Id& map_id);
-        std::vector<Player*> GetPlayersInSession(const model::GameSession* session);
+
+        // Обходит игроков сессии без перебора всех игроков процесса. Порядок не сохраняется
+        template <typename Fn>
+        void ForEachInSession(const model::GameSession* session, Fn&& fn) const {
+            if (auto it = session_index_.find(session); it != session_index_.end()) {
+                for (const auto* entry : it->second) {
+                    fn(entry->player);
+                }
+            }
+        }
+    private:
+        // Позиция игрока в индексе его сессии хранится рядом с игроком,
+        // поэтому удаление из индекса - перестановка с последним без поиска
+        struct Entry {
+            Player player;
+            size_t session_pos = 0;
+        };
+
+        // Узлы unordered_map не перемещаются, поэтому указатели в индексе остаются действительными
+        std::unordered_map<PlayerKey, Entry, PlayerKeyHasher> players_;
+        std::unordered_map<const model::GameSession*, std::vector<Entry*>> session_index_;
     private:
-        std::unordered_map<PlayerKey, Player, PlayerKeyHasher> players_;
+        void AddToIndex(Entry& entry);
+        void RemoveFromIndex(const Entry& entry);
     };
 } // namespace app
\ No newline at end of file
@@ -0,0 +1,175 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace app {
+    /*
+     * Токен игрока как 128-битное число. Снаружи токен - 32 шестнадцатеричные
+     * цифры (старшая половина, затем младшая), внутри хранится и сравнивается
+     * как два uint64_t, без строк и выделений памяти
+     */
+    struct TokenKey {
+        constexpr static size_t HEX_SIZE = 32;
+
+        uint64_t high = 0;
+        uint64_t low = 0;
+
+        auto operator<=>(const TokenKey&) const = default;
+
+        // std::nullopt, если строка не из 32 шестнадцатеричных цифр в верхнем регистре,
+        // как их выдаёт ToString: токен сравнивается как строка, и другой регистр - другой токен
+        static constexpr std::optional<TokenKey> Parse(std::string_view hex) {
+            if (hex.size() != HEX_SIZE) {
+                return std::nullopt;
+            }
+
+            TokenKey key;
+            for (size_t i = 0; i < HEX_SIZE; ++i) {
+                auto digit = HexDigit(hex[i]);
+                if (digit < 0) {
+                    return std::nullopt;
+                }
+                auto& half = i < HEX_SIZE / 2 ? key.high : key.low;
+                half = (half << 4) | static_cast<uint64_t>(digit);
+            }
+            return key;
+        }
+
+        std::string ToString() const {
+            constexpr std::string_view hex_chars = "0123456789ABCDEF";
+            std::string result(HEX_SIZE, '0');
+            for (size_t i = 0; i < HEX_SIZE / 2; ++i) {
+                const size_t shift = 60 - i * 4;
+                result[i] = hex_chars[(high >> shift) & 0xF];
+                result[i + HEX_SIZE / 2] = hex_chars[(low >> shift) & 0xF];
+            }
+            return result;
+        }
+
+        // Токены случайные, но перемешиваем биты, чтобы не зависеть от генератора
+        constexpr uint64_t Hash() const {
+            uint64_t hash = low ^ (high * 0x9E3779B97F4A7C15ull);
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            return hash;
+        }
+    private:
+        static constexpr int HexDigit(char c) {
+            if (c >= '0' && c <= '9') {
+                return c - '0';
+            }
+            if (c >= 'A' && c <= 'F') {
+                return c - 'A' + 10;
+            }
+            return -1;
+        }
+    };
+
+    /*
+     * Хеш-таблица с открытой адресацией и линейным пробированием.
+     * Все записи лежат в одном массиве, поиск - один расчёт хеша и обычно
+     * одно сравнение. При удалении хвост цепочки сдвигается назад, поэтому
+     * "надгробия" не нужны. Заполненность держится не выше половины
+     */
+    template <typename Value>
+    class TokenTable {
+    public:
+        TokenTable() = default;
+
+        size_t Size() const {
+            return size_;
+        }
+
+        // false, если такой ключ уже есть
+        bool Insert(TokenKey key, Value value) {
+            if ((size_ + 1) * 2 > slots_.size()) {
+                Rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+            }
+
+            size_t index = FindIndex(key);
+            if (slots_[index].used) {
+                return false;
+            }
+
+            slots_[index] = Slot{key, std::move(value), true};
+            ++size_;
+            return true;
+        }
+
+        const Value* Find(TokenKey key) const {
+            if (slots_.empty()) {
+                return nullptr;
+            }
+            const auto& slot = slots_[FindIndex(key)];
+            return slot.used ? &slot.value : nullptr;
+        }
+
+        bool Contains(TokenKey key) const {
+            return Find(key) != nullptr;
+        }
+
+        bool Erase(TokenKey key) {
+            if (slots_.empty()) {
+                return false;
+            }
+
+            size_t hole = FindIndex(key);
+            if (!slots_[hole].used) {
+                return false;
+            }
+
+            // Сдвигаем назад записи, которым освободившаяся ячейка ближе к их исходной
+            const size_t mask = slots_.size() - 1;
+            for (size_t next = (hole + 1) & mask; slots_[next].used; next = (next + 1) & mask) {
+                size_t home = Home(slots_[next].key);
+                if (((next - home) & mask) >= ((next - hole) & mask)) {
+                    slots_[hole] = std::move(slots_[next]);
+                    hole = next;
+                }
+            }
+            slots_[hole] = Slot{};
+            --size_;
+            return true;
+        }
+    private:
+        struct Slot {
+            TokenKey key;
+            Value value{};
+            bool used = false;
+        };
+
+        constexpr static size_t MIN_CAPACITY = 16;
+
+        std::vector<Slot> slots_;
+        size_t size_ = 0;
+    private:
+        size_t Home(TokenKey key) const {
+            return key.Hash() & (slots_.size() - 1);
+        }
+
+        // Ячейка с ключом или первая свободная на его цепочке
+        size_t FindIndex(TokenKey key) const {
+            const size_t mask = slots_.size() - 1;
+            size_t index = Home(key);
+            while (slots_[index].used && slots_[index].key != key) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        void Rehash(size_t capacity) {
+            std::vector<Slot> old = std::exchange(slots_, std::vector<Slot>(capacity));
+            for (auto& slot : old) {
+                if (slot.used) {
+                    slots_[FindIndex(slot.key)] = std::move(slot);
+                }
+            }
+        }
+    };
+} //namespace app
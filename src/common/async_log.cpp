@@ -0,0 +1,225 @@
+#include "async_log.h"
+#include "log_record.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace logger {
+    /*
+     * Кольцевой буфер байтов для одного писателя и одного читателя.
+     * Запись хранится как длина (uint16_t) и данные, может переходить через
+     * конец массива. Позиции только растут, индекс - позиция по модулю размера
+     */
+    class AsyncLogBackend::Ring {
+    public:
+        explicit Ring(size_t size)
+            : buffer_(size)
+            , mask_{size - 1} {
+        }
+
+        bool TryPush(std::string_view record) {
+            const auto length = static_cast<uint16_t>(record.size());
+            const uint64_t need = sizeof(length) + length;
+            const uint64_t tail = tail_.load(std::memory_order_relaxed);
+            const uint64_t head = head_.load(std::memory_order_acquire);
+            if (buffer_.size() - (tail - head) < need) {
+                return false;
+            }
+
+            Write(tail, &length, sizeof(length));
+            Write(tail + sizeof(length), record.data(), length);
+            tail_.store(tail + need, std::memory_order_release);
+            return true;
+        }
+
+        // Дописывает все готовые записи в конец out
+        void PopAll(std::string& out) {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            const uint64_t tail = tail_.load(std::memory_order_acquire);
+            while (head < tail) {
+                uint16_t length = 0;
+                Read(head, &length, sizeof(length));
+                const size_t offset = out.size();
+                out.resize(offset + length);
+                Read(head + sizeof(length), out.data() + offset, length);
+                head += sizeof(length) + length;
+            }
+            head_.store(head, std::memory_order_release);
+        }
+
+        bool Empty() const {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+        // Поток-владелец завершился, буфер можно убрать после того, как он опустеет
+        void Orphan() {
+            orphaned_.store(true, std::memory_order_release);
+        }
+
+        bool IsOrphaned() const {
+            return orphaned_.load(std::memory_order_acquire);
+        }
+    private:
+        std::vector<char> buffer_;
+        const size_t mask_;
+        // Позиции читателя и писателя в разных кеш-линиях, чтобы потоки не мешали друг другу
+        alignas(64) std::atomic<uint64_t> head_ = 0;
+        alignas(64) std::atomic<uint64_t> tail_ = 0;
+        std::atomic<bool> orphaned_ = false;
+    private:
+        void Write(uint64_t position, const void* data, size_t size) {
+            const size_t offset = position & mask_;
+            const size_t first = std::min(size, buffer_.size() - offset);
+            std::memcpy(buffer_.data() + offset, data, first);
+            std::memcpy(buffer_.data(), static_cast<const char*>(data) + first, size - first);
+        }
+
+        void Read(uint64_t position, void* data, size_t size) const {
+            const size_t offset = position & mask_;
+            const size_t first = std::min(size, buffer_.size() - offset);
+            std::memcpy(data, buffer_.data() + offset, first);
+            std::memcpy(static_cast<char*>(data) + first, buffer_.data(), size - first);
+        }
+    };
+
+    namespace {
+        std::atomic<uint64_t> next_backend_id{1};
+
+        // Буфер текущего потока. При завершении потока буфер помечается брошенным
+        struct ThreadRing {
+            uint64_t owner = 0;
+            std::shared_ptr<AsyncLogBackend::Ring> ring;
+
+            ~ThreadRing() {
+                if (ring) {
+                    ring->Orphan();
+                }
+            }
+        };
+
+        thread_local ThreadRing thread_ring;
+    } // namespace
+
+    AsyncLogBackend::AsyncLogBackend(Sink sink, AsyncLogSettings settings)
+        : sink_{std::move(sink)}
+        , settings_{settings}
+        , id_{next_backend_id.fetch_add(1)} {
+        if (settings_.ring_size < RecordBuilder::MAX_SIZE * 2 || (settings_.ring_size & (settings_.ring_size - 1)) != 0) {
+            throw std::invalid_argument("Log ring size must be a power of two of at least 2 records");
+        }
+        writer_ = std::thread([this] {
+            Run();
+        });
+    }
+
+    AsyncLogBackend::~AsyncLogBackend() {
+        Stop();
+    }
+
+    bool AsyncLogBackend::Push(std::string_view record) {
+        // Запись не длиннее RecordBuilder::MAX_SIZE, длина хранится в uint16_t
+        record = record.substr(0, RecordBuilder::MAX_SIZE);
+        if (stopped_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& ring = GetThreadRing();
+        while (!ring.TryPush(record)) {
+            if (settings_.overflow == OverflowPolicy::DROP || stopped_.load(std::memory_order_acquire)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wake_.notify_one();
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void AsyncLogBackend::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mtx_);
+            if (stopped_.exchange(true)) {
+                return;
+            }
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+
+    uint64_t AsyncLogBackend::GetDropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    AsyncLogBackend::Ring& AsyncLogBackend::GetThreadRing() {
+        if (thread_ring.owner != id_) {
+            if (thread_ring.ring) {
+                thread_ring.ring->Orphan();
+            }
+            auto ring = std::make_shared<Ring>(settings_.ring_size);
+            {
+                std::lock_guard<std::mutex> lock(rings_mtx_);
+                rings_.push_back(ring);
+            }
+            thread_ring.owner = id_;
+            thread_ring.ring = std::move(ring);
+        }
+        return *thread_ring.ring;
+    }
+
+    void AsyncLogBackend::Run() {
+        std::string batch;
+        batch.reserve(settings_.batch_size + RecordBuilder::MAX_SIZE);
+
+        while (!stopped_.load(std::memory_order_acquire)) {
+            Drain(batch);
+            ReportDropped(batch);
+            if (!batch.empty()) {
+                sink_(batch);
+                batch.clear();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mtx_);
+            wake_.wait_for(lock, settings_.flush_interval, [this] {
+                return stopped_.load(std::memory_order_acquire);
+            });
+        }
+
+        // Писатели могли успеть добавить записи до остановки
+        Drain(batch);
+        ReportDropped(batch);
+        if (!batch.empty()) {
+            sink_(batch);
+        }
+    }
+
+    void AsyncLogBackend::Drain(std::string& batch) {
+        std::lock_guard<std::mutex> lock(rings_mtx_);
+        for (auto& ring : rings_) {
+            ring->PopAll(batch);
+            if (batch.size() >= settings_.batch_size) {
+                sink_(batch);
+                batch.clear();
+            }
+        }
+
+        std::erase_if(rings_, [](const auto& ring) {
+            return ring->IsOrphaned() && ring->Empty();
+        });
+    }
+
+    void AsyncLogBackend::ReportDropped(std::string& batch) {
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped == reported_dropped_) {
+            return;
+        }
+
+        RecordBuilder record{std::chrono::system_clock::now(), "log records dropped"sv};
+        record.Add("count"sv, dropped - reported_dropped_);
+        batch.append(record.Finish());
+        reported_dropped_ = dropped;
+    }
+} // namespace logger
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace logger {
+    // Что делать, если кольцевой буфер потока заполнен
+    enum class OverflowPolicy {
+        // Запись отбрасывается, число потерь попадает в лог отдельной записью
+        DROP,
+        // Поток ждёт, пока фоновый поток освободит место
+        BLOCK
+    };
+
+    struct AsyncLogSettings {
+        // Размер буфера каждого потока в байтах, степень двойки
+        size_t ring_size = 256 * 1024;
+        OverflowPolicy overflow = OverflowPolicy::DROP;
+        // Как часто фоновый поток проверяет буферы, если записей нет
+        std::chrono::milliseconds flush_interval{10};
+        // Размер пачки, после которого она сразу отдаётся в sink
+        size_t batch_size = 64 * 1024;
+    };
+
+    /*
+     * Асинхронная запись лога. У каждого пишущего потока свой кольцевой буфер
+     * (один писатель, один читатель), поэтому Push не берёт блокировок и не
+     * выделяет память: мьютекс нужен только при первой записи потока, чтобы
+     * зарегистрировать его буфер. Фоновый поток собирает записи из всех
+     * буферов в пачку и отдаёт её в sink одним вызовом
+     */
+    class AsyncLogBackend {
+    public:
+        // Получает пачку целых записей, вызывается только из фонового потока
+        using Sink = std::function<void(std::string_view batch)>;
+
+        explicit AsyncLogBackend(Sink sink, AsyncLogSettings settings = {});
+        ~AsyncLogBackend();
+
+        AsyncLogBackend(const AsyncLogBackend&) = delete;
+        AsyncLogBackend& operator=(const AsyncLogBackend&) = delete;
+
+        // false, если запись отброшена (буфер полон при DROP или backend остановлен)
+        bool Push(std::string_view record);
+        // Дописывает накопленные записи и останавливает фоновый поток
+        void Stop();
+        uint64_t GetDropped() const;
+
+        class Ring;
+    private:
+        Sink sink_;
+        AsyncLogSettings settings_;
+        // Отличает экземпляры, чтобы поток не писал в буфер уничтоженного backend
+        const uint64_t id_;
+
+        std::mutex rings_mtx_;
+        std::vector<std::shared_ptr<Ring>> rings_;
+
+        std::mutex wake_mtx_;
+        std::condition_variable wake_;
+        std::atomic<bool> stopped_ = false;
+        std::atomic<uint64_t> dropped_ = 0;
+        uint64_t reported_dropped_ = 0;
+        std::thread writer_;
+    private:
+        Ring& GetThreadRing();
+        void Run();
+        // Переносит записи из буферов в batch, отдаёт полные пачки в sink
+        void Drain(std::string& batch);
+        void ReportDropped(std::string& batch);
+    };
+} // namespace logger
@@ -0,0 +1,115 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace binary {
+    /*
+     * Запись компактного бинарного формата для нативных клиентов.
+     * Целые числа пишутся как varint (LEB128, младшие 7 бит первыми),
+     * знаковые - предварительно через zigzag, строки - длина varint и байты.
+     * Дробные координаты квантуются: хранится round(value * POSITION_SCALE)
+     */
+    class Writer {
+    public:
+        constexpr static double POSITION_SCALE = 1000.0;
+
+        void WriteByte(uint8_t value) {
+            buffer_.push_back(static_cast<char>(value));
+        }
+
+        void WriteVarint(uint64_t value) {
+            while (value >= 0x80) {
+                buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            buffer_.push_back(static_cast<char>(value));
+        }
+
+        void WriteSigned(int64_t value) {
+            WriteVarint(ZigZag(value));
+        }
+
+        void WriteQuantized(double value) {
+            WriteSigned(static_cast<int64_t>(std::llround(value * POSITION_SCALE)));
+        }
+
+        void WriteString(std::string_view value) {
+            WriteVarint(value.size());
+            buffer_.append(value);
+        }
+
+        std::string Release() {
+            return std::move(buffer_);
+        }
+
+        static constexpr uint64_t ZigZag(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+    private:
+        std::string buffer_;
+    };
+
+    // Обратные операции, используются клиентами и тестами формата
+    class Reader {
+    public:
+        explicit Reader(std::string_view data)
+            : data_{data} {
+        }
+
+        uint8_t ReadByte() {
+            Require(1);
+            uint8_t value = static_cast<uint8_t>(data_[pos_]);
+            ++pos_;
+            return value;
+        }
+
+        uint64_t ReadVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t byte = ReadByte();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            throw std::out_of_range("Varint is too long");
+        }
+
+        int64_t ReadSigned() {
+            uint64_t value = ReadVarint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        double ReadQuantized() {
+            return static_cast<double>(ReadSigned()) / Writer::POSITION_SCALE;
+        }
+
+        std::string_view ReadString() {
+            uint64_t size = ReadVarint();
+            Require(size);
+            auto value = data_.substr(pos_, size);
+            pos_ += size;
+            return value;
+        }
+
+        bool AtEnd() const {
+            return pos_ == data_.size();
+        }
+
+        size_t Remaining() const {
+            return data_.size() - pos_;
+        }
+    private:
+        std::string_view data_;
+        size_t pos_ = 0;
+
+        void Require(uint64_t size) const {
+            if (size > data_.size() - pos_) {
+                throw std::out_of_range("Unexpected end of binary data");
+            }
+        }
+    };
+} //namespace binary
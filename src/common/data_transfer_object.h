@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <tuple>
 
 
 namespace DTO {
@@ -8,6 +9,15 @@ namespace DTO {
         std::string name;
         int64_t score = 0;
         int64_t play_time_ms = 0;
+        // UUID в каноническом виде (строчные буквы), замыкает порядок выдачи рекордов
+        std::string id;
+    };
+
+    // Порядок выдачи рекордов: score по убыванию, затем play_time_ms, name и id по возрастанию
+    struct ScoreOrder {
+        bool operator()(const Score& lhs, const Score& rhs) const {
+            return std::tie(rhs.score, lhs.play_time_ms, lhs.name, lhs.id) < std::tie(lhs.score, rhs.play_time_ms, rhs.name, rhs.id);
+        }
     };
 
     struct ExitPlayer {
@@ -103,6 +103,7 @@ namespace detail {
         for(const auto& road : roads.as_array()){
             map->AddRoad(ParseRoad(road.as_object()));
         }
+        map->BuildRoadIndex();
 
         for(const auto& building : buildings.as_array()){
             map->AddBuilding(ParseBuilding(building.as_object()));
@@ -111,6 +112,7 @@ namespace detail {
         for(const auto& office : offices.as_array()){
             map->AddOffice(ParseOffice(office.as_object()));
         }
+        map->BuildOfficeGrid();
 
         return map;
     }
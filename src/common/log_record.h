@@ -0,0 +1,193 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string_view>
+#include <type_traits>
+
+
+namespace logger {
+    using namespace std::literals;
+
+    /*
+     * Строит JSON-запись лога прямо в буфере фиксированного размера, без
+     * выделения памяти:
+     * {"timestamp":"2024-01-01T12:00:00.000000","message":"...","data":{...}}\n
+     * Поля, которые не поместились, отбрасываются, длинные строки обрезаются,
+     * в обоих случаях в data добавляется "truncated":true
+     */
+    class RecordBuilder {
+    public:
+        constexpr static size_t MAX_SIZE = 1024;
+
+        RecordBuilder(std::chrono::system_clock::time_point timestamp, std::string_view message) {
+            Append("{\"timestamp\":\""sv);
+            AppendTimestamp(timestamp);
+            Append("\",\"message\":"sv);
+            AppendString(message);
+            Append(",\"data\":{"sv);
+        }
+
+        RecordBuilder(const RecordBuilder&) = delete;
+        RecordBuilder& operator=(const RecordBuilder&) = delete;
+
+        // Значение - строка (std::string, std::string_view, const char*), число или bool
+        template <typename T>
+        void Add(std::string_view key, const T& value) {
+            if (truncated_) {
+                return;
+            }
+
+            const size_t field_start = size_;
+            Append(first_field_ ? "\""sv : ",\""sv);
+            AppendEscaped(key);
+            Append("\":"sv);
+            if (truncated_) {
+                size_ = field_start;
+                return;
+            }
+
+            if constexpr (std::is_same_v<std::decay_t<T>, bool>) {
+                Append(value ? "true"sv : "false"sv);
+            } else if constexpr (std::is_arithmetic_v<std::decay_t<T>>) {
+                AppendNumber(value);
+            } else {
+                static_assert(std::is_convertible_v<const T&, std::string_view>, "Unsupported log value type");
+                // Обрезанная строка остаётся в записи, если от неё поместилась хотя бы кавычка
+                const size_t value_start = size_;
+                AppendString(std::string_view{value});
+                if (size_ == value_start) {
+                    size_ = field_start;
+                    return;
+                }
+                first_field_ = false;
+                return;
+            }
+
+            if (truncated_) {
+                size_ = field_start;
+                return;
+            }
+            first_field_ = false;
+        }
+
+        // Завершает запись. Результат действителен, пока жив построитель
+        std::string_view Finish() {
+            if (truncated_) {
+                AppendTail(first_field_ ? "\"truncated\":true"sv : ",\"truncated\":true"sv);
+            }
+            AppendTail("}}\n"sv);
+            return {buffer_.data(), size_};
+        }
+    private:
+        // Место под закрывающую кавычку и хвост Finish
+        constexpr static size_t TAIL_RESERVE = 24;
+        constexpr static size_t LIMIT = MAX_SIZE - TAIL_RESERVE;
+
+        std::array<char, MAX_SIZE> buffer_;
+        size_t size_ = 0;
+        bool first_field_ = true;
+        bool truncated_ = false;
+    private:
+        void Append(std::string_view text) {
+            if (truncated_ || size_ + text.size() > LIMIT) {
+                truncated_ = true;
+                return;
+            }
+            AppendTail(text);
+        }
+
+        // Запись в зарезервированное место, лимит не проверяется
+        void AppendTail(std::string_view text) {
+            std::copy(text.begin(), text.end(), buffer_.data() + size_);
+            size_ += text.size();
+        }
+
+        void AppendString(std::string_view text) {
+            if (truncated_ || size_ + 1 > LIMIT) {
+                truncated_ = true;
+                return;
+            }
+            AppendTail("\""sv);
+            AppendEscaped(text);
+            AppendTail("\""sv);
+        }
+
+        void AppendEscaped(std::string_view text) {
+            constexpr std::string_view hex = "0123456789abcdef"sv;
+            for (size_t i = 0; i < text.size() && !truncated_; ++i) {
+                const char c = text[i];
+                const auto uc = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    const char escaped[] = {'\\', c};
+                    AppendChars(escaped, 2);
+                } else if (c == '\n') {
+                    AppendChars("\\n", 2);
+                } else if (c == '\r') {
+                    AppendChars("\\r", 2);
+                } else if (c == '\t') {
+                    AppendChars("\\t", 2);
+                } else if (uc < 0x20) {
+                    const char escaped[] = {'\\', 'u', '0', '0', hex[uc >> 4], hex[uc & 0xF]};
+                    AppendChars(escaped, 6);
+                } else {
+                    AppendChars(&c, 1);
+                }
+            }
+        }
+
+        void AppendChars(const char* chars, size_t count) {
+            if (size_ + count > LIMIT) {
+                truncated_ = true;
+                // Не оставляем в конце обрезанный символ UTF-8
+                while (size_ > 0 && (static_cast<unsigned char>(buffer_[size_ - 1]) & 0xC0) == 0x80) {
+                    --size_;
+                }
+                if (size_ > 0 && (static_cast<unsigned char>(buffer_[size_ - 1]) & 0xC0) == 0xC0) {
+                    --size_;
+                }
+                return;
+            }
+            AppendTail({chars, count});
+        }
+
+        template <typename Number>
+        void AppendNumber(Number value) {
+            std::array<char, 32> digits;
+            auto [ptr, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+            Append({digits.data(), static_cast<size_t>(ptr - digits.data())});
+        }
+
+        // ISO 8601 в UTC с микросекундами: gmtime_r, в отличие от localtime_r, не берёт блокировок
+        void AppendTimestamp(std::chrono::system_clock::time_point timestamp) {
+            using namespace std::chrono;
+            const auto since_epoch = duration_cast<microseconds>(timestamp.time_since_epoch());
+            const std::time_t seconds = duration_cast<std::chrono::seconds>(since_epoch).count();
+            const auto micros = static_cast<int>((since_epoch % std::chrono::seconds{1}).count());
+
+            std::tm tm{};
+            gmtime_r(&seconds, &tm);
+
+            std::array<char, 32> text;
+            char* out = text.data();
+            const auto put = [&out](int value, int width) {
+                for (int i = width - 1; i >= 0; --i) {
+                    out[i] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                }
+                out += width;
+            };
+            put(tm.tm_year + 1900, 4); *out++ = '-';
+            put(tm.tm_mon + 1, 2); *out++ = '-';
+            put(tm.tm_mday, 2); *out++ = 'T';
+            put(tm.tm_hour, 2); *out++ = ':';
+            put(tm.tm_min, 2); *out++ = ':';
+            put(tm.tm_sec, 2); *out++ = '.';
+            put(micros, 6);
+            Append({text.data(), static_cast<size_t>(out - text.data())});
+        }
+    };
+} // namespace logger
@@ -1,46 +1,39 @@
 #include "logger.h"
-#include <boost/log/utility/setup/common_attributes.hpp>
-#include <boost/log/utility/setup/console.hpp>
-#include <boost/date_time.hpp>
-#include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <memory>
 
 
 namespace logger {
-    using namespace std::literals;
-    namespace keywords = boost::log::keywords;
-    BOOST_LOG_ATTRIBUTE_KEYWORD(timestamp, "TimeStamp", boost::posix_time::ptime)
-
-    void JsonFormatter(logging::record_view const& rec, logging::formatting_ostream& strm) {
-        json::object obj;
-
-        if(auto ts = rec[timestamp]) {
-            obj["timestamp"s] = boost::posix_time::to_iso_extended_string(*ts);
+    namespace {
+        void WriteToStdout(std::string_view data) {
+            std::fwrite(data.data(), 1, data.size(), stdout);
+            std::fflush(stdout);
         }
 
-        obj["message"s] = *rec[logging::expressions::smessage];
-
-        if (auto data = rec[additional_data]) {
-            obj["data"s] = *data;
-        } else {
-            obj["data"s] = json::object{};
-        }
+        // Создаётся в Init до запуска рабочих потоков, удаляется при выходе из программы
+        std::unique_ptr<AsyncLogBackend> backend;
+        std::atomic<AsyncLogBackend*> active_backend = nullptr;
+    } // namespace
 
-        strm << obj;
+    void Logger::Init(AsyncLogSettings settings){
+        backend = std::make_unique<AsyncLogBackend>(&WriteToStdout, settings);
+        active_backend.store(backend.get(), std::memory_order_release);
     }
 
-    void Logger::Init(){
-        logging::add_common_attributes();
-        
-        auto console_sink = logging::add_console_log(
-            std::cout,
-            keywords::format = &JsonFormatter,
-            keywords::auto_flush = true
-        );
+    void Logger::Shutdown() {
+        active_backend.store(nullptr, std::memory_order_release);
+        if (backend) {
+            backend->Stop();
+        }
+    }
 
-        logging::core::get()->set_filter(
-            logging::trivial::severity >= logging::trivial::info
-        );
+    void Logger::Write(std::string_view record) {
+        if (auto* async = active_backend.load(std::memory_order_acquire)) {
+            async->Push(record);
+            return;
+        }
+        WriteToStdout(record);
     }
 
 } // namespace logger
-
@@ -1,59 +1,66 @@
 #pragma once
-#include <boost/log/trivial.hpp>     // для BOOST_LOG_TRIVIAL
-#include <boost/log/core.hpp>        // для logging::core
-#include <boost/log/expressions.hpp> // для выражения, задающего фильтр 
-#include <boost/log/utility/manipulators/add_value.hpp>
-#include <boost/json.hpp>
-#include <string>
+#include <chrono>
+#include <string_view>
 
+#include "async_log.h"
+#include "log_record.h"
 
 
 
-namespace logger {
-    namespace logging = boost::log;
-    namespace json = boost::json;
-    BOOST_LOG_ATTRIBUTE_KEYWORD(additional_data, "AdditionalData", json::value)
 
+namespace logger {
+    /*
+     * Структурированный лог в stdout: одна JSON-запись на строку.
+     * Запись собирается в буфере на стеке (RecordBuilder) и передаётся
+     * фоновому потоку (AsyncLogBackend), поэтому вызывающий поток не ждёт
+     * вывода. До Init записи выводятся синхронно
+     */
     class Logger {
     public:
-        static void Init();
+        static void Init(AsyncLogSettings settings = {});
+        // Дописывает очередь в stdout. Дальнейшие записи выводятся синхронно
+        static void Shutdown();
 
+        // Аргументы - пары ключ, значение (строка, число или bool)
         template<typename... Args>
-        static void LogInfo(const std::string& message, Args&&... args){
-            json::value data = BuildData(std::forward<Args>(args)...);
-            BOOST_LOG_TRIVIAL(info) << logging::add_value(additional_data, data) << message;
+        static void LogInfo(std::string_view message, const Args&... args){
+            Log(message, args...);
         }
 
         template<typename... Args>
-        static void LogWarning(const std::string& message, Args&&... args){
-            json::value data = BuildData(std::forward<Args>(args)...);
-            BOOST_LOG_TRIVIAL(warning) << logging::add_value(additional_data, data) << message;
+        static void LogWarning(std::string_view message, const Args&... args){
+            Log(message, args...);
         }
 
         template<typename... Args>
-        static void LogError(const std::string& message, Args&&... args){
-            json::value data = BuildData(std::forward<Args>(args)...);
-            BOOST_LOG_TRIVIAL(error) << logging::add_value(additional_data, data) << message;
+        static void LogError(std::string_view message, const Args&... args){
+            Log(message, args...);
         }
 
         template<typename... Args>
-        static void LogFatal(const std::string& message, Args&&... args){
-            json::value data = BuildData(std::forward<Args>(args)...);
-            BOOST_LOG_TRIVIAL(fatal) << logging::add_value(additional_data, data) << message;
+        static void LogFatal(std::string_view message, const Args&... args){
+            Log(message, args...);
         }
 
     private:
-        static json::value BuildData() {
-             return json::object{};
+        template<typename... Args>
+        static void Log(std::string_view message, const Args&... args) {
+            static_assert(sizeof...(Args) % 2 == 0, "Log data must be key-value pairs");
+            RecordBuilder record{std::chrono::system_clock::now(), message};
+            AddData(record, args...);
+            Write(record.Finish());
+        }
+
+        static void AddData(RecordBuilder&) {
         }
 
         template<typename T, typename... Rest>
-        static json::value BuildData(const std::string& key, T&& value, Rest&&... rest) {
-            json::object obj = BuildData(std::forward<Rest>(rest)...).as_object();
-            obj[key] = json::value_from(std::forward<T>(value));
-            return obj;
+        static void AddData(RecordBuilder& record, std::string_view key, const T& value, const Rest&... rest) {
+            record.Add(key, value);
+            AddData(record, rest...);
         }
 
+        static void Write(std::string_view record);
     };
 
-} // namespace logger
\ No newline at end of file
+} // namespace logger
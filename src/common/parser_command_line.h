@@ -15,6 +15,10 @@ namespace parser_command_line {
         bool randomize_spawn_points;
         std::optional<std::string> state_file;
         std::optional<int64_t> save_state_period;
+        int64_t score_flush_period = 500;
+        size_t score_batch_size = 100;
+        size_t records_cache_pages = 10;
+        std::optional<std::string> score_file;
     };
 
     [[nodiscard]] std::optional<Args> ParseCommandLine(int argc, const char* const argv[]) {
@@ -28,6 +32,7 @@ namespace parser_command_line {
         int64_t tick_period_val = 0;
         int64_t save_state_period = 0;
         std::string state_file;
+        std::string score_file;
 
         desc.add_options()
             ("help,h", "produce help message")
@@ -36,7 +41,11 @@ namespace parser_command_line {
             ("www-root,w", po::value(&args.www_root)->required()->value_name("dir"), "set static files root")
             ("randomize-spawn-points", po::bool_switch(&args.randomize_spawn_points), "spawn dogs at random positions")
             ("state-file", po::value(&state_file)->value_name("file"), "set state file path")
-            ("save-state-period", po::value(&save_state_period)->value_name("milliseconds"), "set save state period");
+            ("save-state-period", po::value(&save_state_period)->value_name("milliseconds"), "set save state period")
+            ("score-flush-period", po::value(&args.score_flush_period)->default_value(args.score_flush_period)->value_name("milliseconds"), "set period of writing retired players to the database")
+            ("score-batch-size", po::value(&args.score_batch_size)->default_value(args.score_batch_size)->value_name("count"), "set max number of retired players written at once")
+            ("records-cache-pages", po::value(&args.records_cache_pages)->default_value(args.records_cache_pages)->value_name("count"), "set number of 100-record pages served from memory")
+            ("score-file", po::value(&score_file)->value_name("file"), "store records in a local file instead of PostgreSQL");
         
         po::variables_map vm;
         try{
@@ -66,6 +75,15 @@ namespace parser_command_line {
             args.state_file = std::move(state_file);
         }
 
+        if(vm.contains("score-file")) {
+            args.score_file = std::move(score_file);
+        }
+
+        if (args.score_flush_period <= 0 || args.score_batch_size == 0) {
+            std::cout << "Error parsing command line: score flush period and batch size must be positive" << std::endl;
+            return std::nullopt;
+        }
+
         return args;
     }
 }//parser_command_line
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+
+namespace http_server {
+    namespace beast = boost::beast;
+    namespace http = beast::http;
+
+    /*
+     * Тело ответа - диапазон байт файла на диске.
+     * HTTP-сессия отправляет такое тело через sendfile, минуя буферы в
+     * пространстве пользователя (см. SessionBase::Write). Обычный writer нужен
+     * для остальных случаев: он читает файл кусками, как http::file_body
+     */
+    struct FileRangeBody {
+        class value_type {
+        public:
+            void Open(const char* path, beast::error_code& ec) {
+                file_.open(path, beast::file_mode::read, ec);
+            }
+
+            void SetRange(uint64_t offset, uint64_t length) {
+                offset_ = offset;
+                length_ = length;
+            }
+
+            const beast::file& GetFile() const {
+                return file_;
+            }
+
+            beast::file& GetFile() {
+                return file_;
+            }
+
+            uint64_t GetOffset() const {
+                return offset_;
+            }
+
+            uint64_t GetLength() const {
+                return length_;
+            }
+        private:
+            beast::file file_;
+            uint64_t offset_ = 0;
+            uint64_t length_ = 0;
+        };
+
+        static std::uint64_t size(const value_type& body) {
+            return body.GetLength();
+        }
+
+        class writer {
+        public:
+            using const_buffers_type = boost::asio::const_buffer;
+
+            template <bool isRequest, class Fields>
+            writer(const http::header<isRequest, Fields>&, value_type& body)
+                : body_{body}
+                , remaining_{body.GetLength()} {
+            }
+
+            void init(beast::error_code& ec) {
+                body_.GetFile().seek(body_.GetOffset(), ec);
+            }
+
+            boost::optional<std::pair<const_buffers_type, bool>> get(beast::error_code& ec) {
+                ec = {};
+                if (remaining_ == 0) {
+                    return boost::none;
+                }
+
+                auto amount = static_cast<size_t>(std::min<uint64_t>(remaining_, buffer_.size()));
+                auto read = body_.GetFile().read(buffer_.data(), amount, ec);
+                if (ec) {
+                    return boost::none;
+                }
+                if (read == 0) {
+                    ec = http::error::short_read;
+                    return boost::none;
+                }
+
+                remaining_ -= read;
+                return {{const_buffers_type{buffer_.data(), read}, remaining_ > 0}};
+            }
+
+        private:
+            value_type& body_;
+            uint64_t remaining_;
+            std::array<char, 64 * 1024> buffer_;
+        };
+    };
+
+} //namespace http_server
@@ -2,8 +2,14 @@
 #include "logger.h"
 
 #include <boost/asio/dispatch.hpp>
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
 namespace http_server {
     void ReportError(beast::error_code ec, std::string_view what) {
         logger::Logger::LogInfo("error"s,
@@ -54,9 +60,95 @@ namespace http_server {
         if (ec) {
             return ReportError(ec, "read"sv);
         }
+        // Поток забрал обработчик апгрейда, HTTP-сессия на этом завершается
+        if (websocket::is_upgrade(request_) && HandleUpgrade(request_)) {
+            return;
+        }
         HandleRequest(std::move(request_));
     }
 
+    void SessionBase::Write(http::response<FileRangeBody>&& response) {
+#ifdef __linux__
+        auto safe_response = std::make_shared<http::response<FileRangeBody>>(std::move(response));
+        auto serializer = std::make_shared<http::response_serializer<FileRangeBody>>(*safe_response);
+
+        // Заголовки пишет Beast, тело - ядро напрямую из файла в сокет
+        auto self = GetSharedThis();
+        http::async_write_header(stream_, *serializer,
+                                 [safe_response, serializer, self](beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+                                     if (ec) {
+                                         return ReportError(ec, "write"sv);
+                                     }
+                                     const auto& body = safe_response->body();
+                                     self->SendFile(safe_response, body.GetOffset(), body.GetLength());
+                                 });
+#else
+        Write<FileRangeBody, http::fields>(std::move(response));
+#endif
+    }
+
+    void SessionBase::SendFile(std::shared_ptr<http::response<FileRangeBody>> response, uint64_t offset, uint64_t remaining) {
+#ifdef __linux__
+        // За один вызов отправляем не больше куска, чтобы не занимать поток надолго
+        constexpr uint64_t MAX_CHUNK = 1024 * 1024;
+        // Столько ждём, пока клиент освободит буфер сокета, как и при чтении запроса
+        constexpr auto SEND_TIMEOUT = 30s;
+
+        auto& socket = stream_.socket();
+        while (remaining > 0) {
+            beast::error_code ec;
+            socket.native_non_blocking(true, ec);
+
+            off_t file_offset = static_cast<off_t>(offset);
+            auto sent = ::sendfile(socket.native_handle(), response->body().GetFile().native_handle(),
+                                   &file_offset, static_cast<size_t>(std::min(remaining, MAX_CHUNK)));
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                return ReportError(beast::error_code(errno, sys::system_category()), "sendfile"sv);
+            }
+            if (sent == 0) {
+                // Файл оказался короче заявленного в Content-Length
+                return ReportError(http::error::short_read, "sendfile"sv);
+            }
+
+            if (sent > 0) {
+                offset += static_cast<uint64_t>(sent);
+                remaining -= static_cast<uint64_t>(sent);
+                if (remaining == 0) {
+                    break;
+                }
+            }
+
+            // Клиент, который не читает ответ, не должен держать соединение и файл вечно:
+            // по истечении срока ожидание сокета отменяется
+            send_timer_.expires_after(SEND_TIMEOUT);
+            send_timer_.async_wait([self = GetSharedThis()](beast::error_code ec) {
+                // Таймер мог сработать одновременно с готовностью сокета и уже быть перезапущен
+                if (ec || self->send_timer_.expiry() > net::steady_timer::clock_type::now()) {
+                    return;
+                }
+                beast::error_code cancel_ec;
+                self->stream_.socket().cancel(cancel_ec);
+            });
+
+            // Ждём готовности сокета: буфер заполнен или кусок отправлен и пора уступить поток
+            socket.async_wait(tcp::socket::wait_write,
+                              [self = GetSharedThis(), response = std::move(response), offset, remaining](beast::error_code ec) mutable {
+                                  self->send_timer_.cancel();
+                                  if (ec) {
+                                      return ReportError(ec == net::error::operation_aborted ? beast::error::timeout : ec, "sendfile"sv);
+                                  }
+                                  self->SendFile(std::move(response), offset, remaining);
+                              });
+            return;
+        }
+
+        OnWrite(response->need_eof(), {}, 0);
+#endif
+    }
+
     void SessionBase::Close() {
         beast::error_code ec;
         stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
@@ -2,9 +2,14 @@
 #include "sdk.h"
 
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <functional>
+
+#include "file_range_body.h"
 
 namespace http_server {
 
@@ -13,10 +18,18 @@ namespace sys = boost::system;
 using tcp = net::ip::tcp;
 namespace beast = boost::beast;
 namespace http = beast::http;
+namespace websocket = beast::websocket;
 using namespace std::literals;
 
 void ReportError(beast::error_code ec, std::string_view what);
 
+/*
+ * Обработчик запроса на апгрейд соединения (WebSocket). Если он забрал поток
+ * из tcp_stream, то возвращает true и HTTP-сессия завершается, иначе запрос
+ * обрабатывается как обычный HTTP-запрос
+ */
+using UpgradeHandler = std::function<bool(const http::request<http::string_body>&, beast::tcp_stream&)>;
+
 class SessionBase {
 public:
     // Запрещаем копирование и присваивание объектов SessionBase и его наследников
@@ -27,7 +40,8 @@ protected:
     using HttpRequest = http::request<http::string_body>;
 
     explicit SessionBase(tcp::socket&& socket)
-        : stream_(std::move(socket)) {
+        : stream_(std::move(socket))
+        , send_timer_(stream_.get_executor()) {
     }
 
     template <typename Body, typename Fields>
@@ -42,6 +56,9 @@ protected:
                           });
     }
 
+    // Тело-файл отправляется через sendfile (на Linux), минуя буферы Beast
+    void Write(http::response<FileRangeBody>&& response);
+
     ~SessionBase() = default;
 private:
     // tcp_stream содержит внутри себя сокет и добавляет поддержку таймаутов
@@ -49,27 +66,34 @@ private:
     HttpRequest request_;
 protected:
     beast::tcp_stream stream_;
+private:
+    // Таймаут tcp_stream не действует на ожидание сокета в SendFile, у него свой таймер
+    net::steady_timer send_timer_;
 private:
     void OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written);
     void Read();
     void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
     void Close();
+    void SendFile(std::shared_ptr<http::response<FileRangeBody>> response, uint64_t offset, uint64_t remaining);
 
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
     // Обработку запроса делегируем подклассу
     virtual void HandleRequest(HttpRequest&& request) = 0;
+    virtual bool HandleUpgrade(const HttpRequest& request) = 0;
 };
 
 template <typename RequestHandler>
 class Session : public SessionBase, public std::enable_shared_from_this<Session<RequestHandler>> {
 public:
     template <typename Handler>
-    Session(tcp::socket&& socket, Handler&& request_handler)
+    Session(tcp::socket&& socket, Handler&& request_handler, UpgradeHandler upgrade_handler = {})
         : SessionBase(std::move(socket))
-        , request_handler_(std::forward<Handler>(request_handler)) {
+        , request_handler_(std::forward<Handler>(request_handler))
+        , upgrade_handler_(std::move(upgrade_handler)) {
     }
 private:
     RequestHandler request_handler_;
+    UpgradeHandler upgrade_handler_;
 private:
     std::shared_ptr<SessionBase> GetSharedThis() override {
         return this->shared_from_this();
@@ -84,17 +108,22 @@ private:
             self->Write(std::move(response));
         });
     }
+
+    bool HandleUpgrade(const HttpRequest& request) override {
+        return upgrade_handler_ && upgrade_handler_(request, stream_);
+    }
 };
 
 template <typename RequestHandler>
 class Listener : public std::enable_shared_from_this<Listener<RequestHandler>> {
 public:
     template <typename Handler>
-    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler)
+    Listener(net::io_context& ioc, const tcp::endpoint& endpoint, Handler&& request_handler, UpgradeHandler upgrade_handler = {})
         : ioc_(ioc)
         // Обработчики асинхронных операций acceptor_ будут вызываться в своём strand
         , acceptor_(net::make_strand(ioc))
-        , request_handler_(std::forward<Handler>(request_handler)) {
+        , request_handler_(std::forward<Handler>(request_handler))
+        , upgrade_handler_(std::move(upgrade_handler)) {
         // Открываем acceptor, используя протокол (IPv4 или IPv6), указанный в endpoint
         acceptor_.open(endpoint.protocol());
 
@@ -118,6 +147,7 @@ private:
     net::io_context& ioc_;
     tcp::acceptor acceptor_;
     RequestHandler request_handler_;
+    UpgradeHandler upgrade_handler_;
 
 private:
     void DoAccept() {
@@ -152,7 +182,7 @@ private:
     }
 
     void AsyncRunSession(tcp::socket&& socket) {
-        std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_)->Run();
+        std::make_shared<Session<RequestHandler>>(std::move(socket), request_handler_, upgrade_handler_)->Run();
     }
 };
 
@@ -165,4 +195,12 @@ void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandl
     std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler))->Run();
 }
 
+// Как ServeHttp, но запросы на апгрейд соединения сначала передаются upgrade_handler
+template <typename RequestHandler>
+void ServeHttp(net::io_context& ioc, const tcp::endpoint& endpoint, RequestHandler&& handler, UpgradeHandler upgrade_handler) {
+    using MyListener = Listener<std::decay_t<RequestHandler>>;
+
+    std::make_shared<MyListener>(ioc, endpoint, std::forward<RequestHandler>(handler), std::move(upgrade_handler))->Run();
+}
+
 }  // namespace http_server
@@ -0,0 +1,157 @@
+#include "websocket_session.h"
+#include "http_server.h"
+#include "logger.h"
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+namespace http_server {
+    WebSocketSession::WebSocketSession(beast::tcp_stream&& stream)
+        : ws_(std::move(stream)) {
+    }
+
+    void WebSocketSession::Run(http::request<http::string_body> request, MessageHandler on_message, CloseHandler on_close) {
+        request_ = std::move(request);
+        on_message_ = std::move(on_message);
+        on_close_ = std::move(on_close);
+
+        net::dispatch(ws_.get_executor(), [self = shared_from_this()] {
+            // У websocket::stream свои таймауты и ping, таймер tcp_stream отключаем
+            beast::get_lowest_layer(self->ws_).expires_never();
+            self->ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+            self->ws_.text(true);
+            self->ws_.async_accept(self->request_,
+                beast::bind_front_handler(&WebSocketSession::OnAccept, self));
+        });
+    }
+
+    void WebSocketSession::Send(Message message) {
+        net::post(ws_.get_executor(), [self = shared_from_this(), message = std::move(message)]() mutable {
+            if (self->closing_ || self->finished_) {
+                return;
+            }
+
+            // Клиент не успевает читать: копить сообщения бесконечно нельзя,
+            // а выбросить часть изменений состояния тоже нельзя, поэтому отключаем его
+            if (self->queue_.size() >= MAX_QUEUE_SIZE) {
+                logger::Logger::LogInfo("websocket overflow"s,
+                    "queue_size"s, self->queue_.size()
+                );
+                return self->DoClose(websocket::close_code::try_again_later);
+            }
+
+            self->queue_.push_back(std::move(message));
+            if (self->open_ && self->queue_.size() == 1) {
+                self->Write();
+            }
+        });
+    }
+
+    void WebSocketSession::Close(websocket::close_code code) {
+        net::post(ws_.get_executor(), [self = shared_from_this(), code] {
+            self->DoClose(code);
+        });
+    }
+
+    void WebSocketSession::OnAccept(beast::error_code ec) {
+        if (ec) {
+            ReportError(ec, "websocket accept"sv);
+            return Finish();
+        }
+
+        open_ = true;
+        Read();
+
+        if (!queue_.empty()) {
+            if (closing_) {
+                queue_.erase(queue_.begin() + 1, queue_.end());
+            }
+            Write();
+        } else if (closing_) {
+            StartClose();
+        }
+    }
+
+    void WebSocketSession::Read() {
+        ws_.async_read(buffer_, beast::bind_front_handler(&WebSocketSession::OnRead, shared_from_this()));
+    }
+
+    void WebSocketSession::OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read) {
+        if (ec == websocket::error::closed) {
+            // Нормальная ситуация - клиент закрыл соединение
+            return Finish();
+        }
+        if (ec) {
+            if (!closing_) {
+                ReportError(ec, "websocket read"sv);
+            }
+            return Finish();
+        }
+
+        auto data = buffer_.data();
+        on_message_(std::string_view{static_cast<const char*>(data.data()), data.size()});
+        buffer_.consume(buffer_.size());
+
+        Read();
+    }
+
+    void WebSocketSession::Write() {
+        ws_.async_write(net::buffer(*queue_.front()),
+            beast::bind_front_handler(&WebSocketSession::OnWrite, shared_from_this()));
+    }
+
+    void WebSocketSession::OnWrite(beast::error_code ec, [[maybe_unused]] std::size_t bytes_written) {
+        if (ec) {
+            ReportError(ec, "websocket write"sv);
+            return Finish();
+        }
+
+        queue_.pop_front();
+        if (!queue_.empty()) {
+            Write();
+        } else if (closing_) {
+            StartClose();
+        }
+    }
+
+    void WebSocketSession::DoClose(websocket::close_code code) {
+        if (closing_ || finished_) {
+            return;
+        }
+        closing_ = true;
+        close_code_ = code;
+
+        if (!open_) {
+            // Закроем после рукопожатия
+            return;
+        }
+
+        if (queue_.empty()) {
+            StartClose();
+        } else {
+            // Текущая запись уже идёт, close отправится после неё
+            queue_.erase(queue_.begin() + 1, queue_.end());
+        }
+    }
+
+    void WebSocketSession::StartClose() {
+        ws_.async_close(close_code_, [self = shared_from_this()](beast::error_code ec) {
+            if (ec) {
+                ReportError(ec, "websocket close"sv);
+            }
+            self->Finish();
+        });
+    }
+
+    void WebSocketSession::Finish() {
+        if (finished_) {
+            return;
+        }
+        finished_ = true;
+        queue_.clear();
+
+        if (on_close_) {
+            on_close_();
+        }
+    }
+}  // namespace http_server
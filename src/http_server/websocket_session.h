@@ -0,0 +1,67 @@
+#pragma once
+#include "sdk.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace http_server {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+
+/*
+ * WebSocket-соединение, полученное апгрейдом HTTP-сессии.
+ * Вся работа с потоком идёт в его executor (strand соединения), поэтому
+ * Send и Close можно вызывать из любого потока.
+ * Исходящие сообщения пишутся по одному; если клиент не успевает их забирать
+ * и очередь превышает MAX_QUEUE_SIZE, соединение закрывается
+ */
+class WebSocketSession : public std::enable_shared_from_this<WebSocketSession> {
+public:
+    using Message = std::shared_ptr<const std::string>;
+    using MessageHandler = std::function<void(std::string_view)>;
+    using CloseHandler = std::function<void()>;
+
+    constexpr static size_t MAX_QUEUE_SIZE = 64;
+
+    explicit WebSocketSession(beast::tcp_stream&& stream);
+
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+
+    // Завершает рукопожатие по запросу на апгрейд и запускает чтение сообщений
+    void Run(http::request<http::string_body> request, MessageHandler on_message, CloseHandler on_close);
+    void Send(Message message);
+    void Close(websocket::close_code code = websocket::close_code::normal);
+private:
+    websocket::stream<beast::tcp_stream> ws_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    std::deque<Message> queue_;
+    MessageHandler on_message_;
+    CloseHandler on_close_;
+    // Рукопожатие завершено, можно писать
+    bool open_ = false;
+    // Закрытие запрошено: новые сообщения не принимаются, close отправится после текущей записи
+    bool closing_ = false;
+    bool finished_ = false;
+    websocket::close_code close_code_ = websocket::close_code::normal;
+private:
+    void OnAccept(beast::error_code ec);
+    void Read();
+    void OnRead(beast::error_code ec, [[maybe_unused]] std::size_t bytes_read);
+    void Write();
+    void OnWrite(beast::error_code ec, [[maybe_unused]] std::size_t bytes_written);
+    void DoClose(websocket::close_code code);
+    void StartClose();
+    void Finish();
+};
+
+}  // namespace http_server
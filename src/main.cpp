@@ -8,6 +8,7 @@
 #include "json_loader.h"
 #include "request_handler.h"
 #include "logging_request_handler.h"
+#include "game_socket_handler.h"
 #include "http_server.h"
 #include "parser_command_line.h"
 #include "ticker.h"
@@ -16,6 +17,7 @@
 #include "state_file_io.h"
 #include "auto_saver.h"
 #include "postgres.h"
+#include "local_store.h"
 
 using namespace std::literals;
 namespace net = boost::asio;
@@ -67,11 +69,29 @@ int main(int argc, const char* argv[]) {
         }
 
         logger::Logger::Init();
-        std::string url_db = GetUrlFromEnv();
+        // С локальным файлом рекордов PostgreSQL не нужен
+        std::optional<std::string> url_db;
+        if (!args->score_file.has_value()) {
+            url_db = GetUrlFromEnv();
+        }
         // 2. Загружаем конфигурацию из файла
         model::Game game = json_loader::LoadGame(args->config_file, args->randomize_spawn_points);
         extra_data::ExtraData data = json_loader::LoadMapExtraData(args->config_file);
-        app::Application app(url_db);
+        std::optional<postgres::DataBase> database;
+        std::optional<postgres::LocalScoreStore> local_store;
+        if (url_db.has_value()) {
+            // Соединения нужны потокам ввода-вывода, читающим рекорды, и потоку записи рекордов
+            const unsigned db_pool_size = std::max(1u, std::thread::hardware_concurrency()) + 1;
+            database.emplace(*url_db, postgres::DataBaseSettings{.pool_size = db_pool_size});
+        } else {
+            local_store.emplace(*args->score_file);
+        }
+        auto& factory_uow = database.has_value() ? database->GetFactory() : local_store->GetFactory();
+
+        app::Application app(factory_uow, postgres::ScoreWriterSettings{
+            .flush_interval = std::chrono::milliseconds(args->score_flush_period),
+            .max_batch_size = args->score_batch_size
+        }, args->records_cache_pages);
 
         // 3. Восстанавливаем состояния сервера с последнего запуска
         if (args->state_file.has_value()) {
@@ -114,6 +134,12 @@ int main(int argc, const char* argv[]) {
         http_handler::RequestHandler handler{game, app, data, args->www_root, api_strand, args->tick_period};
         http_handler::LoggingRequestHandler logging_handler{&handler};
 
+        // WebSocket-канал рассылает изменения состояния после каждого тика
+        http_handler::GameSocketHandler socket_handler{game, app, net::make_strand(ioc)};
+        game.DoTick([&socket_handler]([[maybe_unused]] int64_t time_delta) {
+            socket_handler.OnTick();
+        });
+
         // 9. Запускаем игровые часы, кроме тестового случая
         std::shared_ptr<ticker::Ticker> game_ticker;
         if (args->tick_period.has_value()) {
@@ -136,6 +162,8 @@ int main(int argc, const char* argv[]) {
         constexpr net::ip::port_type port = 8080;
         http_server::ServeHttp(ioc, {address, port}, [&logging_handler](auto&& req, std::string client_ip, auto&& send) {
             logging_handler(std::forward<decltype(req)>(req), std::move(client_ip), std::forward<decltype(send)>(send));
+        }, [&socket_handler](const http_handler::StringRequest& req, boost::beast::tcp_stream& stream) {
+            return socket_handler(req, stream);
         });
 
         logger::Logger::LogInfo("server started"s,
@@ -158,11 +186,13 @@ int main(int argc, const char* argv[]) {
             "code"s, EXIT_FAILURE,
             "exception"s, ex.what()
         );
+        logger::Logger::Shutdown();
         return EXIT_FAILURE;
     }
 
     logger::Logger::LogInfo("server exited"s,
         "code"s, EXIT_SUCCESS
     );
+    logger::Logger::Shutdown();
     return EXIT_SUCCESS;
 }
@@ -1,5 +1,7 @@
 #include "collision_detector.h"
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace collision_detector {
@@ -68,4 +70,147 @@ std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provide
     return detected_events;
 }
 
+void ItemGrid::Build(std::span<const Item> items, double max_gatherer_width) {
+    //Ячейки меньше этого размера не дают выигрыша, а только увеличивают число обходимых ячеек
+    constexpr double MIN_CELL_SIZE = 0.5;
+
+    max_item_width_ = 0;
+    for (const auto& item : items) {
+        max_item_width_ = std::max(max_item_width_, item.width);
+    }
+    cell_size_ = std::max(MIN_CELL_SIZE, max_gatherer_width + max_item_width_);
+
+    items_.clear();
+    cell_keys_.clear();
+    cell_start_.clear();
+
+    items_.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        items_.push_back({items[i], i});
+    }
+
+    auto key = [this](const GridItem& grid_item) {
+        return MakeKey(ToCell(grid_item.item.position.x), ToCell(grid_item.item.position.y));
+    };
+
+    std::sort(items_.begin(), items_.end(), [&key](const GridItem& lhs, const GridItem& rhs) {
+        return key(lhs) < key(rhs);
+    });
+
+    for (size_t i = 0; i < items_.size(); ++i) {
+        const uint64_t cell_key = key(items_[i]);
+        if (cell_keys_.empty() || cell_keys_.back() != cell_key) {
+            cell_keys_.push_back(cell_key);
+            cell_start_.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    cell_start_.push_back(static_cast<uint32_t>(items_.size()));
+}
+
+void ItemGrid::CollectEvents(std::span<const Gatherer> gatherers, std::vector<GatheringEvent>& events) const {
+    if (items_.empty()) {
+        return;
+    }
+
+    for (size_t g = 0; g < gatherers.size(); ++g) {
+        const auto& gatherer = gatherers[g];
+        if (gatherer.start_pos.x == gatherer.end_pos.x && gatherer.start_pos.y == gatherer.end_pos.y) {
+            //Пропуск нулевых перемещенний
+            continue;
+        }
+
+        //Ограничивающий прямоугольник перемещения, расширенный на радиус сбора
+        const double radius = gatherer.width + max_item_width_;
+        const int64_t x0 = ToCell(std::min(gatherer.start_pos.x, gatherer.end_pos.x) - radius);
+        const int64_t x1 = ToCell(std::max(gatherer.start_pos.x, gatherer.end_pos.x) + radius);
+        const int64_t y0 = ToCell(std::min(gatherer.start_pos.y, gatherer.end_pos.y) - radius);
+        const int64_t y1 = ToCell(std::max(gatherer.start_pos.y, gatherer.end_pos.y) + radius);
+
+        //Перемещение задевает больше ячеек, чем занято предметами. Быстрее проверить все предметы
+        const double cells_count = (static_cast<double>(x1 - x0) + 1) * (static_cast<double>(y1 - y0) + 1);
+        if (cells_count > static_cast<double>(cell_keys_.size())) {
+            CollectEvents(gatherer, g, items_.data(), items_.data() + items_.size(), events);
+            continue;
+        }
+
+        for (int64_t x = x0; x <= x1; ++x) {
+            for (int64_t y = y0; y <= y1; ++y) {
+                const uint64_t cell_key = MakeKey(x, y);
+                auto it = std::lower_bound(cell_keys_.begin(), cell_keys_.end(), cell_key);
+                if (it == cell_keys_.end() || *it != cell_key) {
+                    continue;
+                }
+
+                const auto cell = static_cast<size_t>(it - cell_keys_.begin());
+                CollectEvents(gatherer, g, items_.data() + cell_start_[cell], items_.data() + cell_start_[cell + 1], events);
+            }
+        }
+    }
+}
+
+void ItemGrid::CollectEvents(const Gatherer& gatherer, size_t gatherer_id, const GridItem* begin, const GridItem* end,
+                             std::vector<GatheringEvent>& events) const {
+    for (auto it = begin; it != end; ++it) {
+        auto collect_result = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, it->item.position);
+
+        if (collect_result.IsCollected(gatherer.width + it->item.width)) {
+            events.push_back(GatheringEvent{
+                .item_id = it->item_id,
+                .gatherer_id = gatherer_id,
+                .sq_distance = collect_result.sq_distance,
+                .time = collect_result.proj_ratio
+            });
+        }
+    }
+}
+
+int64_t ItemGrid::ToCell(double coord) const {
+    //Координаты ячеек помещаются в 32 бита ключа
+    constexpr double LIMIT = std::numeric_limits<int32_t>::max();
+    return static_cast<int64_t>(std::clamp(std::floor(coord / cell_size_), -LIMIT, LIMIT));
+}
+
+uint64_t ItemGrid::MakeKey(int64_t cell_x, int64_t cell_y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32) | static_cast<uint32_t>(cell_y);
+}
+
+void SortGatherEvents(std::vector<GatheringEvent>& events) {
+    std::sort(events.begin(), events.end(),
+        [](const GatheringEvent& e_l, const GatheringEvent& e_r) {
+            if (e_l.time != e_r.time) {
+                return e_l.time < e_r.time;
+            }
+            if (e_l.gatherer_id != e_r.gatherer_id) {
+                return e_l.gatherer_id < e_r.gatherer_id;
+            }
+            return e_l.item_id < e_r.item_id;
+        }
+    );
+}
+
+std::vector<GatheringEvent> FindGatherEventsBroadphase(const ItemGathererProvider& provider) {
+    std::vector<Item> items;
+    items.reserve(provider.ItemsCount());
+    for (size_t i = 0; i < provider.ItemsCount(); ++i) {
+        items.push_back(provider.GetItem(i));
+    }
+
+    std::vector<Gatherer> gatherers;
+    gatherers.reserve(provider.GatherersCount());
+    double max_gatherer_width = 0;
+    for (size_t g = 0; g < provider.GatherersCount(); ++g) {
+        gatherers.push_back(provider.GetGatherer(g));
+        max_gatherer_width = std::max(max_gatherer_width, gatherers.back().width);
+    }
+
+    ItemGrid grid;
+    grid.Build(items, max_gatherer_width);
+
+    std::vector<GatheringEvent> detected_events;
+    grid.CollectEvents(gatherers, detected_events);
+    SortGatherEvents(detected_events);
+
+    return detected_events;
+}
+
 }  // namespace collision_detector
\ No newline at end of file
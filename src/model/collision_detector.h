@@ -3,6 +3,8 @@
 #include "geometry.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace collision_detector {
@@ -51,6 +53,51 @@ struct GatheringEvent {
     double time;
 };
 
+// Эталонная реализация: проверяет каждую пару собиратель-предмет
 std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProvider& provider);
 
+/*
+ * Равномерная сетка предметов для грубой фазы поиска столкновений.
+ * Размер ячейки равен максимальной ширине сбора, поэтому перемещение собирателя
+ * проверяется только с предметами из ячеек, которые оно пересекает.
+ * Сетку можно перестраивать без новых выделений памяти.
+ */
+class ItemGrid {
+public:
+    void Build(std::span<const Item> items, double max_gatherer_width);
+
+    // Добавляет в events события сбора предметов сетки. gatherer_id события - индекс в gatherers
+    void CollectEvents(std::span<const Gatherer> gatherers, std::vector<GatheringEvent>& events) const;
+
+    size_t ItemsCount() const noexcept {
+        return items_.size();
+    }
+
+private:
+    struct GridItem {
+        Item item;
+        size_t item_id;
+    };
+
+    double cell_size_ = 1;
+    double max_item_width_ = 0;
+    // Отсортированные ключи непустых ячеек
+    std::vector<uint64_t> cell_keys_;
+    // Предметы ячейки cell_keys_[i] лежат в items_[cell_start_[i]..cell_start_[i + 1])
+    std::vector<uint32_t> cell_start_;
+    std::vector<GridItem> items_;
+
+private:
+    int64_t ToCell(double coord) const;
+    static uint64_t MakeKey(int64_t cell_x, int64_t cell_y);
+    void CollectEvents(const Gatherer& gatherer, size_t gatherer_id, const GridItem* begin, const GridItem* end,
+                       std::vector<GatheringEvent>& events) const;
+};
+
+// Упорядочивает события по времени, при равном времени - по собирателю и предмету
+void SortGatherEvents(std::vector<GatheringEvent>& events);
+
+// Тот же результат, что и FindGatherEvents, но с грубой фазой на ItemGrid
+std::vector<GatheringEvent> FindGatherEventsBroadphase(const ItemGathererProvider& provider);
+
 }  // namespace collision_detector
\ No newline at end of file
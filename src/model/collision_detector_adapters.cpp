@@ -36,8 +36,8 @@ namespace collision_detector {
         return  items;
     }
 
-    std::vector<Item> LootToItems(const std::vector<model::Loot>& loots) {
-        std::vector<Item> items;
+    void LootToItems(const std::vector<model::Loot>& loots, std::vector<Item>& items) {
+        items.clear();
 
         for (const auto& loot : loots) {
             Item item {
@@ -50,12 +50,10 @@ namespace collision_detector {
             
             items.push_back(std::move(item));
         }
-
-        return  items;
     }
 
-    std::vector<Gatherer> DogsToGatherers(const std::vector<std::pair<model::Dog::Id, model::VecMove>>& dogs_pos){
-        std::vector<Gatherer> gatherers;
+    void DogsToGatherers(const std::vector<std::pair<model::Dog::Id, model::VecMove>>& dogs_pos, std::vector<Gatherer>& gatherers){
+        gatherers.clear();
 
         for (const auto& [dog_id, dog_pos] : dogs_pos) {
             Gatherer gatherer{
@@ -66,8 +64,6 @@ namespace collision_detector {
 
             gatherers.push_back(std::move(gatherer));
         }
-
-        return gatherers;
     }
 
 
@@ -30,7 +30,8 @@ namespace collision_detector {
     };
 
     std::vector<Item> OfficesToItems(const std::vector<model::Office>& offices);
-    std::vector<Item> LootToItems(const std::vector<model::Loot>& loots);
-    std::vector<Gatherer> DogsToGatherers(const std::vector<std::pair<model::Dog::Id, model::VecMove>>& dogs_pos);
+    // Заполняют items/gatherers заново, сохраняя выделенную память между тиками
+    void LootToItems(const std::vector<model::Loot>& loots, std::vector<Item>& items);
+    void DogsToGatherers(const std::vector<std::pair<model::Dog::Id, model::VecMove>>& dogs_pos, std::vector<Gatherer>& gatherers);
 
 } // namespace collision_detector
\ No newline at end of file
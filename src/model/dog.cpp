@@ -1,4 +1,5 @@
 #include "dog.h"
+#include "dog_store.h"
 #include <stdexcept>
 #include <numeric>
 
@@ -13,15 +14,15 @@ namespace model {
     }
 
     Position Dog::GetPos() const {
-        return pos_;
+        return store_->GetPos(slot_);
     }
 
     Speed Dog::GetSpeed() const {
-        return speed_;
+        return store_->GetSpeed(slot_);
     }
 
     Direction Dog::GetDir() const {
-        return dir_;
+        return store_->GetDir(slot_);
     }
 
     const Dog::Bag& Dog::GetBag() const {
@@ -54,50 +55,58 @@ namespace model {
     }
     
     int64_t Dog::GetPlayTime() const {
-        return play_time_ms_;
+        return store_->GetPlayTime(slot_);
     }
 
-    void Dog::Action(std::string_view dir) {
+    DogAction MakeDogAction(uint64_t dog_id, std::string_view dir) {
         if (dir.empty()) {
-            speed_.v_speed = 0;
-            speed_.h_speed = 0;
-            return;
+            return DogAction{.dog_id = dog_id, .stop = true};
         }
 
         if (dir == "U") {
-            dir_ = Direction::NORTH;
-            speed_.v_speed = -max_speed_;
-            speed_.h_speed = 0;
-            return;
+            return DogAction{.dog_id = dog_id, .dir = Direction::NORTH, .stop = false};
         }
 
         if (dir == "D") {
-            dir_ = Direction::SOUTH;
-            speed_.v_speed = max_speed_;
-            speed_.h_speed = 0;
-            return;
+            return DogAction{.dog_id = dog_id, .dir = Direction::SOUTH, .stop = false};
         }
 
         if (dir == "L") {
-            dir_ = Direction::WEST;
-            speed_.v_speed = 0;
-            speed_.h_speed = -max_speed_;
-            return;
+            return DogAction{.dog_id = dog_id, .dir = Direction::WEST, .stop = false};
         }
 
         if (dir == "R") {
-            dir_ = Direction::EAST;
-            speed_.v_speed = 0;
-            speed_.h_speed = max_speed_;
+            return DogAction{.dog_id = dog_id, .dir = Direction::EAST, .stop = false};
+        }
+
+        throw std::invalid_argument("Invalid direction in MakeDogAction");
+    }
+
+    void Dog::Action(const DogAction& action) {
+        if (action.stop) {
+            store_->SetSpeed(slot_, {.h_speed = 0, .v_speed = 0});
             return;
         }
 
-        // Сюда программа не дожна попадать. Невалидное значение строки направления
-        throw std::invalid_argument("Invalid direction in Dog::Action");
+        store_->SetDir(slot_, action.dir);
+        switch (action.dir) {
+        case Direction::NORTH:
+            store_->SetSpeed(slot_, {.h_speed = 0, .v_speed = -max_speed_});
+            break;
+        case Direction::SOUTH:
+            store_->SetSpeed(slot_, {.h_speed = 0, .v_speed = max_speed_});
+            break;
+        case Direction::WEST:
+            store_->SetSpeed(slot_, {.h_speed = -max_speed_, .v_speed = 0});
+            break;
+        case Direction::EAST:
+            store_->SetSpeed(slot_, {.h_speed = max_speed_, .v_speed = 0});
+            break;
+        }
     }
 
     void Dog::SetPos(Position new_pos) {
-        pos_ = new_pos;
+        store_->SetPos(slot_, new_pos);
     }
 
     //Обмен предметов на очки. Вызывать при столкновении с базой
@@ -111,24 +120,10 @@ namespace model {
         bag_.clear();
     }
 
-    void Dog::IncreaseInternalTime(int64_t delta_time) const {
-        if (speed_.v_speed == 0 && speed_.h_speed == 0) {
-            idle_time_ += delta_time;
-        } else {
-            idle_time_ = 0;
-        }
-
-        play_time_ms_ += delta_time;
-    }
-
-    bool Dog::IsRetirment(const int64_t retirement_time) const {
-        return idle_time_ >= retirement_time;
-    }
-    
     void Dog::Restore(Position pos, Speed speed, Direction dir, const Bag& bag, int score) {
-        pos_ = pos;
-        speed_ = speed;
-        dir_ = dir;
+        store_->SetPos(slot_, pos);
+        store_->SetSpeed(slot_, speed);
+        store_->SetDir(slot_, dir);
         bag_ = bag;
         score_ = score;
     }
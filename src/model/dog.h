@@ -5,6 +5,7 @@
 #include "tagged.h"
 #include "geometry.h"
 #include <vector>
+#include <string_view>
  
 
 namespace model {
@@ -16,16 +17,39 @@ namespace model {
         int price = 0;
     };
 
+    /*
+     * Команда управления собакой. Тривиально копируемая,
+     * чтобы передаваться через lock-free очередь сессии
+     */
+    struct DogAction {
+        uint64_t dog_id = 0;
+        Direction dir = Direction::NORTH;
+        bool stop = true;
+    };
+
+    // Разбирает направление из API ("U", "D", "L", "R" или пустая строка для остановки)
+    DogAction MakeDogAction(uint64_t dog_id, std::string_view dir);
+
+    class DogStore;
+
+    /*
+     * Собака хранит редко меняющиеся данные: имя, рюкзак, очки.
+     * Позиция, скорость, направление и таймеры хранятся в DogStore сессии
+     * в слоте slot_, который DogStore обновляет при переносе собаки.
+     */
     class Dog {
     public:
         using Id = util::Tagged<uint64_t, Dog>;
         using Bag = std::vector<Loot>;
 
-        explicit Dog(Id id, const std::string& name, double max_speed, size_t bag_capacity) 
+        // Создаётся через DogStore::AddDog
+        explicit Dog(Id id, const std::string& name, double max_speed, size_t bag_capacity, DogStore& store, size_t slot) 
            : dog_id_{id}
            , name_{name}
            , max_speed_{max_speed}
-           , bag_capacity_{bag_capacity} {
+           , bag_capacity_{bag_capacity}
+           , store_{&store}
+           , slot_{slot} {
         }
 
         const Id& GetId() const;
@@ -39,25 +63,22 @@ namespace model {
         size_t GetBagCapacity() const;
         int64_t GetPlayTime() const;        
 
-        void Action(std::string_view dir);
+        void Action(const DogAction& action);
         void SetPos(Position pos);
         bool AddLoot(const Loot& loot);
         bool IsBagFull() const;
         void ExchangesLootToPoints();
-        void IncreaseInternalTime(int64_t delta_time) const;
-        bool IsRetirment(const int64_t retirement_time) const;
         void Restore(Position pos, Speed speed, Direction dir, const Bag& bag, int score);
     private:
         Id dog_id_;
         std::string name_;
-        Position pos_;
-        Speed speed_;
         double max_speed_;
-        Direction dir_ = Direction::NORTH;
         Bag bag_;
         const size_t bag_capacity_;
         int score_ = 0;
-        mutable int64_t idle_time_ = 0;
-        mutable int64_t play_time_ms_ = 0;
+        DogStore* store_;
+        size_t slot_;
+
+        friend class DogStore;
     };
 } //namespace model
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "dog_store.h"
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+
+namespace model {
+
+    DogStore::Slot DogStore::Add(const Dog::Id& id, Position pos) {
+        const Slot slot = ids_.size();
+        if (auto [it, inserted] = id_to_slot_.emplace(id, slot); !inserted) {
+            throw std::invalid_argument("Duplicate dog id");
+        }
+
+        ids_.push_back(id);
+        dogs_.push_back(nullptr);
+        pos_x_.push_back(pos.x);
+        pos_y_.push_back(pos.y);
+        speed_h_.push_back(0);
+        speed_v_.push_back(0);
+        target_x_.push_back(pos.x);
+        target_y_.push_back(pos.y);
+        dir_.push_back(Direction::NORTH);
+        idle_since_.push_back(MOVING);
+        join_time_.push_back(now_);
+        //Новая собака стоит на месте
+        MarkIdle(slot);
+
+        return slot;
+    }
+
+    Dog& DogStore::AddDog(const Dog::Id& id, Position pos, const std::string& name, double max_speed, size_t bag_capacity) {
+        const Slot slot = Add(id, pos);
+        dogs_[slot] = std::make_unique<Dog>(id, name, max_speed, bag_capacity, *this, slot);
+        return *dogs_[slot];
+    }
+
+    void DogStore::Remove(const Dog::Id& id) {
+        auto it = id_to_slot_.find(id);
+        if (it == id_to_slot_.end()) {
+            return;
+        }
+
+        const Slot slot = it->second;
+        const Slot last = ids_.size() - 1;
+        id_to_slot_.erase(it);
+
+        //Переносим последнюю собаку на освободившийся слот
+        if (slot != last) {
+            ids_[slot] = ids_[last];
+            dogs_[slot] = std::move(dogs_[last]);
+            if (dogs_[slot] != nullptr) {
+                dogs_[slot]->slot_ = slot;
+            }
+            pos_x_[slot] = pos_x_[last];
+            pos_y_[slot] = pos_y_[last];
+            speed_h_[slot] = speed_h_[last];
+            speed_v_[slot] = speed_v_[last];
+            target_x_[slot] = target_x_[last];
+            target_y_[slot] = target_y_[last];
+            dir_[slot] = dir_[last];
+            idle_since_[slot] = idle_since_[last];
+            join_time_[slot] = join_time_[last];
+            id_to_slot_.at(ids_[slot]) = slot;
+        }
+
+        ids_.pop_back();
+        dogs_.pop_back();
+        pos_x_.pop_back();
+        pos_y_.pop_back();
+        speed_h_.pop_back();
+        speed_v_.pop_back();
+        target_x_.pop_back();
+        target_y_.pop_back();
+        dir_.pop_back();
+        idle_since_.pop_back();
+        join_time_.pop_back();
+    }
+
+    void DogStore::Clear() {
+        id_to_slot_.clear();
+        ids_.clear();
+        dogs_.clear();
+        pos_x_.clear();
+        pos_y_.clear();
+        speed_h_.clear();
+        speed_v_.clear();
+        target_x_.clear();
+        target_y_.clear();
+        dir_.clear();
+        idle_since_.clear();
+        join_time_.clear();
+        idle_heap_.clear();
+    }
+
+    DogStore::Slot DogStore::GetSlot(const Dog::Id& id) const {
+        return id_to_slot_.at(id);
+    }
+
+    size_t DogStore::Size() const noexcept {
+        return ids_.size();
+    }
+
+    Dog* DogStore::FindDog(const Dog::Id& id) {
+        auto it = id_to_slot_.find(id);
+        return it != id_to_slot_.end() ? dogs_[it->second].get() : nullptr;
+    }
+
+    const Dog* DogStore::FindDog(const Dog::Id& id) const {
+        auto it = id_to_slot_.find(id);
+        return it != id_to_slot_.end() ? dogs_[it->second].get() : nullptr;
+    }
+
+    Dog& DogStore::GetDog(Slot slot) {
+        return *dogs_[slot];
+    }
+
+    const Dog& DogStore::GetDog(Slot slot) const {
+        return *dogs_[slot];
+    }
+
+    const Dog::Id& DogStore::GetId(Slot slot) const {
+        return ids_[slot];
+    }
+
+    Position DogStore::GetPos(Slot slot) const {
+        return {pos_x_[slot], pos_y_[slot]};
+    }
+
+    Speed DogStore::GetSpeed(Slot slot) const {
+        return {speed_h_[slot], speed_v_[slot]};
+    }
+
+    Direction DogStore::GetDir(Slot slot) const {
+        return dir_[slot];
+    }
+
+    int64_t DogStore::GetIdleTime(Slot slot) const {
+        return idle_since_[slot] == MOVING ? 0 : now_ - idle_since_[slot];
+    }
+
+    int64_t DogStore::GetPlayTime(Slot slot) const {
+        return now_ - join_time_[slot];
+    }
+
+    Position DogStore::GetTarget(Slot slot) const {
+        return {target_x_[slot], target_y_[slot]};
+    }
+
+    void DogStore::SetPos(Slot slot, Position pos) {
+        pos_x_[slot] = pos.x;
+        pos_y_[slot] = pos.y;
+    }
+
+    void DogStore::SetSpeed(Slot slot, Speed speed) {
+        speed_h_[slot] = speed.h_speed;
+        speed_v_[slot] = speed.v_speed;
+
+        if (speed.h_speed != 0 || speed.v_speed != 0) {
+            idle_since_[slot] = MOVING;
+        } else if (idle_since_[slot] == MOVING) {
+            MarkIdle(slot);
+        }
+    }
+
+    void DogStore::SetDir(Slot slot, Direction dir) {
+        dir_[slot] = dir;
+    }
+
+    void DogStore::ComputeTargets(double time_delta_s) {
+        const size_t size = ids_.size();
+        const double* pos_x = pos_x_.data();
+        const double* pos_y = pos_y_.data();
+        const double* speed_h = speed_h_.data();
+        const double* speed_v = speed_v_.data();
+        double* target_x = target_x_.data();
+        double* target_y = target_y_.data();
+
+        for (size_t i = 0; i < size; ++i) {
+            target_x[i] = pos_x[i] + speed_h[i] * time_delta_s;
+            target_y[i] = pos_y[i] + speed_v[i] * time_delta_s;
+        }
+    }
+
+    void DogStore::AdvanceTime(int64_t time_delta) {
+        now_ += time_delta;
+    }
+
+    void DogStore::CollectIdle(int64_t idle_limit, std::vector<Dog::Id>& ids) {
+        const auto greater = std::greater<IdleEntry>{};
+
+        while (!idle_heap_.empty() && now_ - idle_heap_.front().idle_since >= idle_limit) {
+            std::pop_heap(idle_heap_.begin(), idle_heap_.end(), greater);
+            const IdleEntry entry = idle_heap_.back();
+            idle_heap_.pop_back();
+
+            //Запись устарела: собака ушла или с тех пор двигалась
+            auto it = id_to_slot_.find(entry.id);
+            if (it == id_to_slot_.end() || idle_since_[it->second] != entry.idle_since) {
+                continue;
+            }
+
+            ids.push_back(entry.id);
+        }
+    }
+
+    void DogStore::MarkIdle(Slot slot) {
+        idle_since_[slot] = now_;
+        idle_heap_.push_back({now_, ids_[slot]});
+        std::push_heap(idle_heap_.begin(), idle_heap_.end(), std::greater<IdleEntry>{});
+
+        //Частые остановки копят устаревшие записи, поэтому иногда пересобираем кучу
+        if (idle_heap_.size() > 2 * ids_.size() + 64) {
+            CompactIdleHeap();
+        }
+    }
+
+    void DogStore::CompactIdleHeap() {
+        idle_heap_.clear();
+        for (Slot slot = 0; slot < ids_.size(); ++slot) {
+            if (idle_since_[slot] != MOVING) {
+                idle_heap_.push_back({idle_since_[slot], ids_[slot]});
+            }
+        }
+        std::make_heap(idle_heap_.begin(), idle_heap_.end(), std::greater<IdleEntry>{});
+    }
+
+} //namespace model
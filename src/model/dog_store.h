@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dog.h"
+#include "geometry.h"
+#include "tagged.h"
+
+
+namespace model {
+
+    /*
+     * "Горячее" состояние собак сессии в виде структуры массивов.
+     * Позиции, скорости, направления и таймеры лежат в плотных массивах,
+     * индексированных номером слота, поэтому обновление за тик - линейный проход по памяти.
+     * Для запросов API по id есть разреженное отображение id -> слот.
+     * При удалении собаки на её слот переносится последняя собака.
+     *
+     * Хранилище владеет и объектами Dog с редко меняющимися данными.
+     * Dog знает свой слот и читает горячее состояние напрямую, без поиска по id.
+     * На Dog ссылаются игроки, поэтому объекты не перемещаются: при удалении
+     * переносится только указатель, а перенесённой собаке обновляется слот.
+     *
+     * Время хранится не счётчиками у каждой собаки, а моментами событий
+     * относительно часов сессии: момент входа в игру и момент остановки.
+     * Остановки складываются в min-heap, поэтому поиск засидевшихся собак
+     * стоит O(k log n) от числа истёкших, а не проход по всем собакам.
+     * Записи кучи не удаляются при движении собаки, а отбрасываются при извлечении.
+     */
+    class DogStore {
+    public:
+        using Slot = size_t;
+
+        // Только горячее состояние, без объекта Dog
+        Slot Add(const Dog::Id& id, Position pos);
+        Dog& AddDog(const Dog::Id& id, Position pos, const std::string& name, double max_speed, size_t bag_capacity);
+        void Remove(const Dog::Id& id);
+        void Clear();
+
+        Slot GetSlot(const Dog::Id& id) const;
+        size_t Size() const noexcept;
+
+        // nullptr, если собаки с таким id нет
+        Dog* FindDog(const Dog::Id& id);
+        const Dog* FindDog(const Dog::Id& id) const;
+        Dog& GetDog(Slot slot);
+        const Dog& GetDog(Slot slot) const;
+
+        const Dog::Id& GetId(Slot slot) const;
+        Position GetPos(Slot slot) const;
+        Speed GetSpeed(Slot slot) const;
+        Direction GetDir(Slot slot) const;
+        int64_t GetIdleTime(Slot slot) const;
+        int64_t GetPlayTime(Slot slot) const;
+        // Позиция, в которую собака придёт без учёта границ дорог. Вычисляется ComputeTargets
+        Position GetTarget(Slot slot) const;
+
+        void SetPos(Slot slot, Position pos);
+        void SetSpeed(Slot slot, Speed speed);
+        void SetDir(Slot slot, Direction dir);
+
+        // Линейный проход по всем собакам
+        void ComputeTargets(double time_delta_s);
+        // Сдвигает часы сессии, O(1)
+        void AdvanceTime(int64_t time_delta);
+        // Добавляет в ids собак, стоящих не меньше idle_limit мс. Найденные собаки повторно не возвращаются
+        void CollectIdle(int64_t idle_limit, std::vector<Dog::Id>& ids);
+
+    private:
+        // Собака движется, момента остановки нет
+        static constexpr int64_t MOVING = -1;
+
+        struct IdleEntry {
+            int64_t idle_since;
+            Dog::Id id;
+
+            bool operator>(const IdleEntry& other) const {
+                return idle_since > other.idle_since;
+            }
+        };
+
+        void MarkIdle(Slot slot);
+        void CompactIdleHeap();
+
+        std::unordered_map<Dog::Id, Slot, util::TaggedHasher<Dog::Id>> id_to_slot_;
+        int64_t now_ = 0;
+
+        std::vector<Dog::Id> ids_;
+        std::vector<std::unique_ptr<Dog>> dogs_;
+        std::vector<double> pos_x_;
+        std::vector<double> pos_y_;
+        std::vector<double> speed_h_;
+        std::vector<double> speed_v_;
+        std::vector<double> target_x_;
+        std::vector<double> target_y_;
+        std::vector<Direction> dir_;
+        std::vector<int64_t> idle_since_;
+        std::vector<int64_t> join_time_;
+        // Куча по idle_since, наверху самая давняя остановка
+        std::vector<IdleEntry> idle_heap_;
+    };
+
+} //namespace model
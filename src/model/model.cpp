@@ -2,13 +2,114 @@
 
 #include <stdexcept>
 #include <random>
-#include <unordered_set>
+#include <latch>
+#include <array>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <boost/asio/post.hpp>
 #include "collision_detector_adapters.h"
 
 
 namespace model {
     using namespace std::literals;
 
+    void RoadIndex::Build(const std::vector<Road>& roads) {
+        //Запас, с которым Road::PointInArea сравнивает координаты
+        constexpr double EPSILON = 0.000001;
+        constexpr double MIN_CELL_SIZE = 8.0;
+        //Ограничение на число ячеек для карт с большими координатами
+        constexpr double MAX_CELLS = 1 << 20;
+
+        cell_start_.clear();
+        road_ids_.clear();
+        cols_ = 0;
+        rows_ = 0;
+
+        if (roads.empty()) {
+            return;
+        }
+
+        Position min = roads.front().GetLeftUp();
+        Position max = roads.front().GetRightDown();
+        for (const auto& road : roads) {
+            min.x = std::min(min.x, road.GetLeftUp().x);
+            min.y = std::min(min.y, road.GetLeftUp().y);
+            max.x = std::max(max.x, road.GetRightDown().x);
+            max.y = std::max(max.y, road.GetRightDown().y);
+        }
+
+        origin_x_ = min.x - EPSILON;
+        origin_y_ = min.y - EPSILON;
+        const double width = max.x - min.x + 2 * EPSILON;
+        const double height = max.y - min.y + 2 * EPSILON;
+        cell_size_ = std::max(MIN_CELL_SIZE, std::sqrt(width * height / MAX_CELLS));
+        cols_ = static_cast<size_t>(width / cell_size_) + 1;
+        rows_ = static_cast<size_t>(height / cell_size_) + 1;
+
+        auto CellRange = [this](const Road& road) {
+            auto ToCell = [this](double coord, double origin, size_t limit) {
+                auto cell = static_cast<size_t>(std::max(0.0, (coord - origin) / cell_size_));
+                return std::min(cell, limit - 1);
+            };
+
+            const auto left_up = road.GetLeftUp();
+            const auto right_down = road.GetRightDown();
+            return std::array<size_t, 4>{
+                ToCell(left_up.x - EPSILON, origin_x_, cols_),
+                ToCell(left_up.y - EPSILON, origin_y_, rows_),
+                ToCell(right_down.x + EPSILON, origin_x_, cols_),
+                ToCell(right_down.y + EPSILON, origin_y_, rows_)
+            };
+        };
+
+        //Первый проход - считаем количество дорог в каждой ячейке
+        cell_start_.assign(cols_ * rows_ + 1, 0);
+        for (const auto& road : roads) {
+            auto [x0, y0, x1, y1] = CellRange(road);
+            for (size_t y = y0; y <= y1; ++y) {
+                for (size_t x = x0; x <= x1; ++x) {
+                    ++cell_start_[y * cols_ + x + 1];
+                }
+            }
+        }
+
+        for (size_t i = 1; i < cell_start_.size(); ++i) {
+            cell_start_[i] += cell_start_[i - 1];
+        }
+
+        //Второй проход - раскладываем индексы дорог по ячейкам
+        road_ids_.resize(cell_start_.back());
+        std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+        for (size_t road_id = 0; road_id < roads.size(); ++road_id) {
+            auto [x0, y0, x1, y1] = CellRange(roads[road_id]);
+            for (size_t y = y0; y <= y1; ++y) {
+                for (size_t x = x0; x <= x1; ++x) {
+                    road_ids_[fill[y * cols_ + x]++] = static_cast<uint32_t>(road_id);
+                }
+            }
+        }
+    }
+
+    std::span<const uint32_t> RoadIndex::FindRoads(Position point) const {
+        if (cols_ == 0 || point.x < origin_x_ || point.y < origin_y_) {
+            return {};
+        }
+
+        const auto x = static_cast<size_t>((point.x - origin_x_) / cell_size_);
+        const auto y = static_cast<size_t>((point.y - origin_y_) / cell_size_);
+        if (x >= cols_ || y >= rows_) {
+            return {};
+        }
+
+        const size_t cell = y * cols_ + x;
+        return std::span<const uint32_t>{road_ids_}.subspan(cell_start_[cell], cell_start_[cell + 1] - cell_start_[cell]);
+    }
+
+    void Map::BuildRoadIndex() {
+        road_index_.Build(roads_);
+    }
+
     void Map::AddOffice(Office office) {
         if (warehouse_id_to_index_.contains(office.GetId())) {
             throw std::invalid_argument("Duplicate warehouse");
@@ -25,6 +126,10 @@ namespace model {
         }
     }
 
+    void Map::BuildOfficeGrid() {
+        office_grid_.Build(collision_detector::OfficesToItems(offices_), collision_detector::WIDTH_GATHERER);
+    }
+
     void Game::AddMap(std::shared_ptr<model::Map> map) {
         const size_t index = maps_.size();
         if (auto [it, inserted] = map_id_to_index_.emplace(map->GetId(), index); !inserted) {
@@ -46,7 +151,8 @@ namespace model {
     }
 
     void Game::AddSession(const std::shared_ptr<Map> map) {
-        auto [it, inserted] = session_.try_emplace(map->GetId(), map, loot_gen_, dog_retirement_time_, randomize_spawn_points_);
+        auto [it, inserted] = session_.try_emplace(map->GetId(), map, loot_gen_, dog_retirement_time_, randomize_spawn_points_,
+                                                   boost::asio::make_strand(tick_pool_->get_executor()));
     }
 
     double Game::GetDefaultSpeed() const {
@@ -58,12 +164,45 @@ namespace model {
     }
 
     void Game::Tick(int64_t time_delta) {
-        for(auto& [map_id, session] : session_) {
+        //Сессии независимы друг от друга, поэтому обновляем их параллельно,
+        //каждую в своём strand вместе с запросами её игроков
+        RunInSessions([time_delta](GameSession& session) {
             session.Tick(time_delta);
-        }
+        });
+
         tick_signal_(time_delta);
     }
 
+    void Game::RunInSessions(const std::function<void(GameSession&)>& fn) {
+        std::latch barrier{static_cast<std::ptrdiff_t>(session_.size())};
+        std::vector<std::exception_ptr> errors(session_.size());
+
+        size_t index = 0;
+        for(auto& [map_id, session] : session_) {
+            boost::asio::post(session.GetStrand(), [&fn, &session, &barrier, &error = errors[index++]] {
+                try {
+                    fn(session);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                barrier.count_down();
+            });
+        }
+
+        //Вызывающий получает управление, когда все сессии обработаны
+        barrier.wait();
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    size_t Game::GetTickThreadsCount() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
     const std::unordered_map<Map::Id, GameSession, Game::MapIdHasher>& Game::GetSessions() const {
         return session_;
     }
@@ -74,97 +213,246 @@ namespace model {
 
     Dog& GameSession::AddDog(const std::string& name) {
         auto dog_id = Dog::Id{++counter_dog_id_};
-        auto[it, inserted] = dogs_.try_emplace(dog_id, dog_id, name, map_->GetDogSpeed(), map_->GetBagCapacity());
-
         auto start_point = GetRandomStartPos();
-        it->second.SetPos(start_point);
-
-        return it->second;
+        auto& dog = dog_store_.AddDog(dog_id, start_point, name, map_->GetDogSpeed(), map_->GetBagCapacity());
+        new_dogs_.push_back(dog_id);
+        return dog;
     }
 
     void GameSession::DeleteDog(const Dog::Id& dog_id) {
-        dogs_.erase(dog_id);
+        dog_store_.Remove(dog_id);
     }
 
     const std::shared_ptr<Map> GameSession::GetMap() const {
         return map_;
     }
 
-    const std::unordered_map<Dog::Id, Dog, GameSession::DogIdHasher>& GameSession::GetDogs() const {
-        return dogs_;
+    Dog* GameSession::FindDog(const Dog::Id& dog_id) {
+        return dog_store_.FindDog(dog_id);
     }
 
-    std::unordered_map<Dog::Id, Dog, GameSession::DogIdHasher>& GameSession::GetDogs() {
-        return dogs_;
+    size_t GameSession::GetDogsCount() const {
+        return dog_store_.Size();
     }
 
     uint64_t GameSession::GetCounterDogId() const {
         return counter_dog_id_;
     }
 
+    void GameSession::PushAction(const DogAction& action) {
+        actions_.push(action);
+        actions_pushed_.fetch_add(1, std::memory_order_release);
+    }
+
+    void GameSession::ApplyActions() {
+        //Забираем только команды, поставленные до начала тика,
+        //иначе непрерывный поток команд не даст тику завершиться
+        const uint64_t pushed = actions_pushed_.load(std::memory_order_acquire);
+        DogAction action;
+        while (actions_popped_ < pushed && actions_.pop(action)) {
+            ++actions_popped_;
+            // Собака могла уйти из игры, пока команда ждала в очереди
+            if (auto* dog = dog_store_.FindDog(Dog::Id{action.dog_id})) {
+                dog->Action(action);
+            }
+        }
+    }
+
     void GameSession::Tick(int64_t time_delta) {
+        ApplyActions();
         IncreaseTimeDogs(time_delta);
         GenerateLoot(time_delta);
 
-        std::vector<std::pair<Dog::Id, VecMove>> dogs_pos;
+        MoveDogs(time_delta);
+        HandleCollisionsItem(dogs_moves_);
+        PublishSnapshot();
+    }
+
+    void GameSession::PublishSnapshot() {
+        const auto prev = GetSnapshot();
+        MergeSnapshotOrder(*prev);
+        new_dogs_.clear();
 
-        for(auto& [dog_id, dog] : dogs_) {
-            auto dog_vec_move = MoveDog(dog, time_delta);
-            dogs_pos.push_back(std::move(dog_vec_move));
+        auto changes = CollectChanges(*prev);
+        //Ничего не изменилось: прежний снимок остаётся актуальным вместе с версией и кэшами ответов
+        if (changes.changed_dogs.empty() && changes.removed_dogs.empty()
+            && changes.added_loot.empty() && changes.removed_loot.empty()) {
+            return;
+        }
+
+        auto snapshot = std::make_shared<SessionSnapshot>();
+        snapshot->version = prev->version + 1;
+        changes.version = snapshot->version;
+        snapshot->loot_in_map = loot_in_map_;
+        snapshot->dogs.reserve(dog_store_.Size());
+
+        //Порядок уже по id, сортировать не нужно. Неизменившиеся собаки копируются из прежнего снимка
+        auto changed = changes.changed_dogs.begin();
+        auto removed = changes.removed_dogs.begin();
+        for (const auto& [id, old, dog] : snapshot_order_) {
+            if (changed != changes.changed_dogs.end() && *changed == id) {
+                snapshot->dogs.push_back(DogSnapshot{
+                    .id = id,
+                    .pos = dog->GetPos(),
+                    .speed = dog->GetSpeed(),
+                    .dir = dog->GetDir(),
+                    .bag = dog->GetBag(),
+                    .score = dog->GetScore()
+                });
+                ++changed;
+            } else if (removed != changes.removed_dogs.end() && *removed == id) {
+                ++removed;
+            } else if (old != nullptr) {
+                snapshot->dogs.push_back(*old);
+            }
         }
 
-        HandleCollisionsItem(dogs_pos);
+        //История изменений переходит в новый снимок со сдвигом окна
+        const auto& prev_history = prev->history;
+        const size_t keep = std::min(prev_history.size(), CHANGES_HISTORY_SIZE - 1);
+        snapshot->history.reserve(keep + 1);
+        snapshot->history.assign(prev_history.end() - keep, prev_history.end());
+        snapshot->history.push_back(std::make_shared<const SessionChanges>(std::move(changes)));
+
+        std::atomic_store(&snapshot_, std::shared_ptr<const SessionSnapshot>(std::move(snapshot)));
     }
 
-    std::pair<Dog::Id,VecMove> GameSession::MoveDog(Dog& dog, int64_t time_delta) {
-        auto CalculateDeltaDistance = [](int64_t time_delta, double linear_speed) {
-            double delta_move = linear_speed * (static_cast<double>(time_delta) / 1000.0);
-            return delta_move;
+    void GameSession::MergeSnapshotOrder(const SessionSnapshot& prev) {
+        const auto less = [](const Dog::Id& lhs, const Dog::Id& rhs) {
+            return *lhs < *rhs;
         };
+        //Новые собаки получают растущие id, но после восстановления порядок не гарантирован
+        std::sort(new_dogs_.begin(), new_dogs_.end(), less);
+
+        //Собаки в снимке отсортированы по id, сливаем с новыми
+        snapshot_order_.clear();
+        auto old_it = prev.dogs.begin();
+        auto new_it = new_dogs_.begin();
+        while (old_it != prev.dogs.end() || new_it != new_dogs_.end()) {
+            if (new_it == new_dogs_.end() || (old_it != prev.dogs.end() && less(old_it->id, *new_it))) {
+                snapshot_order_.push_back({old_it->id, &*old_it});
+                ++old_it;
+            } else if (old_it == prev.dogs.end() || less(*new_it, old_it->id)) {
+                snapshot_order_.push_back({*new_it, nullptr});
+                ++new_it;
+            } else {
+                //Собака восстановлена с тем же id
+                snapshot_order_.push_back({old_it->id, &*old_it});
+                ++old_it;
+                ++new_it;
+            }
+
+            auto& entry = snapshot_order_.back();
+            //Единственный поиск по id за публикацию, дальше собака читается по своему слоту
+            entry.dog = dog_store_.FindDog(entry.id);
+
+            //Одну собаку могли добавить дважды: удалить и снова восстановить
+            while (new_it != new_dogs_.end() && entry.id == *new_it) {
+                ++new_it;
+            }
+        }
+    }
 
-        auto dog_pos = dog.GetPos();
-        auto dog_speed = dog.GetSpeed();
+    SessionChanges GameSession::CollectChanges(const SessionSnapshot& prev) const {
+        const auto same_bag = [](const Dog::Bag& lhs, const Dog::Bag& rhs) {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const Loot& a, const Loot& b) {
+                return a.id == b.id && a.type == b.type;
+            });
+        };
 
-        Position new_pos {
-            .x = dog_pos.x + CalculateDeltaDistance(time_delta, dog_speed.h_speed),
-            .y = dog_pos.y + CalculateDeltaDistance(time_delta, dog_speed.v_speed)
+        const auto same_dog = [&same_bag](const DogSnapshot& old, const Dog& dog) {
+            const auto speed = dog.GetSpeed();
+            return old.pos == dog.GetPos()
+                && old.speed.h_speed == speed.h_speed
+                && old.speed.v_speed == speed.v_speed
+                && old.dir == dog.GetDir()
+                && old.score == dog.GetScore()
+                && same_bag(old.bag, dog.GetBag());
         };
 
-        //Обработать колизии
-        auto collisions_pos = HandleCollisionsWall(dog.GetDir(), dog_pos, new_pos);
+        SessionChanges changes;
 
-        dog.SetPos(collisions_pos);
-        if(new_pos != collisions_pos) {
-            //Остановил dog
-            dog.Action(""sv);
+        //Текущее состояние сравнивается с прежним снимком без построения нового
+        for (const auto& [id, old, dog] : snapshot_order_) {
+            if (dog == nullptr) {
+                if (old != nullptr) {
+                    changes.removed_dogs.push_back(id);
+                }
+            } else if (old == nullptr || !same_dog(*old, *dog)) {
+                changes.changed_dogs.push_back(id);
+            }
         }
 
-        std::pair<Dog::Id, VecMove> dog_vec_move{
-            dog.GetId(),
-            VecMove{
-                .start_pos = dog_pos,
-                .end_pos = new_pos
+        //Лут тоже упорядочен по id: новый добавляется в конец с растущим id
+        auto old_loot = prev.loot_in_map.begin();
+        auto new_loot = loot_in_map_.begin();
+        while (old_loot != prev.loot_in_map.end() || new_loot != loot_in_map_.end()) {
+            if (new_loot == loot_in_map_.end() || (old_loot != prev.loot_in_map.end() && old_loot->id < new_loot->id)) {
+                changes.removed_loot.push_back(old_loot->id);
+                ++old_loot;
+            } else if (old_loot == prev.loot_in_map.end() || new_loot->id < old_loot->id) {
+                changes.added_loot.push_back(new_loot->id);
+                ++new_loot;
+            } else {
+                ++old_loot;
+                ++new_loot;
             }
-        };
+        }
 
-        return dog_vec_move;
+        return changes;
     }
 
-    void GameSession::Restore(const std::vector<Dog> dogs, const std::vector<Loot>& loot_in_map, uint64_t next_dog_id) {
-        std::unordered_map<Dog::Id, Dog, DogIdHasher> dogs_res;
-        for(const auto& dog : dogs) {
-            dogs_res.try_emplace(dog.GetId(), dog);
+    void GameSession::MoveDogs(int64_t time_delta) {
+        //Сначала линейным проходом считаем конечные точки без учёта дорог
+        dog_store_.ComputeTargets(static_cast<double>(time_delta) / 1000.0);
+
+        dogs_moves_.clear();
+        for (DogStore::Slot slot = 0; slot < dog_store_.Size(); ++slot) {
+            const auto dog_pos = dog_store_.GetPos(slot);
+            const auto new_pos = dog_store_.GetTarget(slot);
+
+            //Обработать колизии
+            auto collisions_pos = HandleCollisionsWall(dog_store_.GetDir(slot), dog_pos, new_pos);
+
+            dog_store_.SetPos(slot, collisions_pos);
+            if(new_pos != collisions_pos) {
+                //Остановил dog
+                dog_store_.SetSpeed(slot, Speed{});
+            }
+
+            dogs_moves_.emplace_back(
+                dog_store_.GetId(slot),
+                VecMove{
+                    .start_pos = dog_pos,
+                    .end_pos = new_pos
+                }
+            );
         }
+    }
 
-        dogs_ = std::move(dogs_res);
+    void GameSession::Restore(const std::vector<Loot>& loot_in_map, uint64_t next_dog_id) {
+        dog_store_.Clear();
         loot_in_map_ = loot_in_map;
         counter_dog_id_ = next_dog_id;
+
+        //id лута не сохраняется, выдаём новые по порядку
+        for (auto& loot : loot_in_map_) {
+            loot.id = loot_id_counter_++;
+        }
+    }
+
+    Dog& GameSession::RestoreDog(const Dog::Id& dog_id, const std::string& name, double max_speed, size_t bag_capacity) {
+        auto& dog = dog_store_.AddDog(dog_id, Position{}, name, max_speed, bag_capacity);
+        new_dogs_.push_back(dog_id);
+        return dog;
     }
 
     Position GameSession::HandleCollisionsWall(Direction dir, Position start, Position end) {
         Position res = start;
+        const auto& roads = map_->GetRoads();
 
-        for(const auto& road : map_->GetRoads()) {
+        for(uint32_t road_id : map_->GetRoadIndex().FindRoads(start)) {
+            const auto& road = roads[road_id];
             if(!road.PointInArea(start)) {
                 continue;
             }
@@ -199,53 +487,64 @@ namespace model {
     }
 
     void GameSession::HandleCollisionsItem(const std::vector<std::pair<Dog::Id, VecMove>>& dogs_pos) {
-        auto items_office = collision_detector::OfficesToItems(map_->GetOffices());
-        auto items = collision_detector::LootToItems(loot_in_map_);
-        auto gatherers = collision_detector::DogsToGatherers(dogs_pos);
+        collision_detector::LootToItems(loot_in_map_, loot_items_);
+        collision_detector::DogsToGatherers(dogs_pos, gatherers_);
 
-        //Запоминаем позицию где закончились объекты лута
-        size_t index_base = items.size();
-        //Склеиваем два вектора в один
-        items.reserve(items.size() + items_office.size());
-        items.insert(items.end(), items_office.begin(), items_office.end());
+        //Лут и офисы ищем раздельно, сетка офисов построена при загрузке карты
+        loot_grid_.Build(loot_items_, collision_detector::WIDTH_GATHERER);
 
-        const auto provider = collision_detector::VectorItemGathererProvider(std::move(items), std::move(gatherers));
-        auto events = collision_detector::FindGatherEvents(provider);
+        loot_events_.clear();
+        loot_grid_.CollectEvents(gatherers_, loot_events_);
+        collision_detector::SortGatherEvents(loot_events_);
 
-        //Контейнер индексов поднятых предметов
-        std::unordered_set<size_t> collected_loot; 
+        office_events_.clear();
+        map_->GetOfficeGrid().CollectEvents(gatherers_, office_events_);
+        collision_detector::SortGatherEvents(office_events_);
 
-        for (const auto& event : events) {
-            const auto& [dog_id, dog_vec_move] = dogs_pos[event.gatherer_id];
-            auto& dog = dogs_.at(dog_id);
+        //Флаги поднятых предметов
+        collected_loot_.assign(loot_in_map_.size(), false);
+        bool has_collected = false;
+
+        //Обрабатываем события обоих списков в порядке времени.
+        //При равном времени сначала поднимается предмет, затем происходит сдача на базу
+        auto loot_it = loot_events_.cbegin();
+        auto office_it = office_events_.cbegin();
+        while (loot_it != loot_events_.cend() || office_it != office_events_.cend()) {
+            const bool is_office = loot_it == loot_events_.cend()
+                || (office_it != office_events_.cend() && office_it->time < loot_it->time);
+            const auto& event = is_office ? *office_it++ : *loot_it++;
+
+            //dogs_pos заполняется проходом по слотам, поэтому gatherer_id совпадает со слотом собаки
+            auto& dog = dog_store_.GetDog(event.gatherer_id);
 
             //Игрок вернул предметы на базу
-            if(event.item_id >= index_base) {
+            if(is_office) {
                 dog.ExchangesLootToPoints();
                 continue;
             }
 
             if(dog.AddLoot(loot_in_map_[event.item_id])) {
                 //Игрок поднял предмет
-                collected_loot.emplace(event.item_id);
-            }            
+                collected_loot_[event.item_id] = true;
+                has_collected = true;
+            }
         }
-        
-        //Очистка вектора лута от поднятых предметов
-        if(!collected_loot.empty()) {
-            std::vector<Loot> new_loot_in_map;
-            size_t old_size = loot_in_map_.size();
-            new_loot_in_map.reserve(old_size);
-
-            for (size_t i = 0; i < old_size; ++i) {
-                if(collected_loot.contains(i)) {
+
+        //Очистка вектора лута от поднятых предметов без перевыделения памяти
+        if(has_collected) {
+            size_t new_size = 0;
+            for (size_t i = 0; i < loot_in_map_.size(); ++i) {
+                if(collected_loot_[i]) {
                     continue;
                 }
 
-                new_loot_in_map.push_back(std::move(loot_in_map_[i]));
+                if (new_size != i) {
+                    loot_in_map_[new_size] = std::move(loot_in_map_[i]);
+                }
+                ++new_size;
             }
 
-            std::swap(loot_in_map_, new_loot_in_map);
+            loot_in_map_.resize(new_size);
         }
     }
 
@@ -257,8 +556,9 @@ namespace model {
 
         Position pos;
         if (randomize_spawn_points_) {
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
+            //Сессии обновляются в разных потоках, генератор у каждого потока свой
+            thread_local std::random_device rd;
+            thread_local std::mt19937 gen(rd());
 
             //Случайный выбор дороги
             std::uniform_int_distribution<size_t> road_dist(0, roads.size() - 1);
@@ -282,12 +582,12 @@ namespace model {
     }
 
     void GameSession::GenerateLoot(int64_t time_delta) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        thread_local std::random_device rd;
+        thread_local std::mt19937 gen(rd());
 
         loot_gen::LootGenerator::TimeInterval delta {time_delta};
         size_t num_loot_types = map_->GetNumLootTypes();
-        size_t loot_count = loot_gen_.Generate(delta, loot_in_map_.size(), dogs_.size()); 
+        size_t loot_count = loot_gen_.Generate(delta, loot_in_map_.size(), dog_store_.Size()); 
 
         std::uniform_int_distribution<size_t> loot_dist(0, num_loot_types - 1);
         for(size_t i = 0; i < loot_count; ++i) {
@@ -308,21 +608,23 @@ namespace model {
     }
 
     void GameSession::IncreaseTimeDogs(int64_t time_delta) {
-        auto map_id = map_->GetId();
-        std::vector<DTO::ExitPlayer> exit_players;
-        for(const auto& [dog_id, dog] : dogs_) {
-            dog.IncreaseInternalTime(time_delta);
-            
-            if (dog.IsRetirment(dog_retirement_time_)) {
-                //Превышен лимит бездействия
-                exit_players.emplace_back(*dog_id, *map_id);
-            }
+        dog_store_.AdvanceTime(time_delta);
+
+        //Из кучи достаются только собаки, превысившие лимит бездействия
+        retired_dogs_.clear();
+        dog_store_.CollectIdle(dog_retirement_time_, retired_dogs_);
+        if (retired_dogs_.empty()) {
+            return;
         }
 
-        //Проверка кондидатов на удаление
-        if (!exit_players.empty()) {
-            exit_signal_(exit_players);
+        const auto& map_id = map_->GetId();
+        std::vector<DTO::ExitPlayer> exit_players;
+        exit_players.reserve(retired_dogs_.size());
+        for (const auto& dog_id : retired_dogs_) {
+            exit_players.emplace_back(*dog_id, *map_id);
         }
+
+        exit_signal_(exit_players);
     }
 
 }  // namespace model
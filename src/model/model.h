@@ -3,11 +3,18 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <span>
 #include <boost/signals2.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <functional>
 #include <atomic>
 
 #include "tagged.h"
 #include "dog.h"
+#include "dog_store.h"
+#include "session_snapshot.h"
 #include "geometry.h"
 #include "loot_generator.h"
 #include "collision_detector.h"
@@ -100,6 +107,14 @@ public:
         return point_end;
     }
 
+    Position GetLeftUp() const noexcept {
+        return left_up;
+    }
+
+    Position GetRightDown() const noexcept {
+        return right_down;
+    }
+
 private:
     Point start_;
     Point end_;
@@ -119,6 +134,30 @@ private:
     }
 };
 
+/*
+ * Равномерная сетка над прямоугольниками дорог.
+ * Каждая дорога регистрируется во всех ячейках, которые пересекает её площадь,
+ * поэтому по точке можно сразу получить несколько дорог-кандидатов
+ * вместо перебора всех дорог карты.
+ */
+class RoadIndex {
+public:
+    void Build(const std::vector<Road>& roads);
+
+    // Индексы дорог, в площадь которых может попасть точка
+    std::span<const uint32_t> FindRoads(Position point) const;
+
+private:
+    double origin_x_ = 0;
+    double origin_y_ = 0;
+    double cell_size_ = 1;
+    size_t cols_ = 0;
+    size_t rows_ = 0;
+    // Ячейка i содержит road_ids_[cell_start_[i]..cell_start_[i + 1])
+    std::vector<uint32_t> cell_start_;
+    std::vector<uint32_t> road_ids_;
+};
+
 class Building {
 public:
     explicit Building(Rectangle bounds) noexcept
@@ -196,6 +235,15 @@ public:
         return offices_;
     }
 
+    const RoadIndex& GetRoadIndex() const noexcept {
+        return road_index_;
+    }
+
+    // Офисы неподвижны, поэтому их сетка для поиска столкновений строится один раз
+    const collision_detector::ItemGrid& GetOfficeGrid() const noexcept {
+        return office_grid_;
+    }
+
     double GetDogSpeed() const noexcept {
         return dog_speed_;
     }
@@ -222,16 +270,23 @@ public:
 
     void AddOffice(Office office);
 
+    // Вызывать после добавления всех дорог карты
+    void BuildRoadIndex();
+    // Вызывать после добавления всех офисов карты
+    void BuildOfficeGrid();
+
 private:
     using OfficeIdToIndex = std::unordered_map<Office::Id, size_t, util::TaggedHasher<Office::Id>>;
 
     Id id_;
     std::string name_;
     Roads roads_;
+    RoadIndex road_index_;
     Buildings buildings_;
 
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
+    collision_detector::ItemGrid office_grid_;
     double dog_speed_;
     size_t bag_capacity_;
     const std::vector<int> price_loot_;
@@ -240,39 +295,102 @@ private:
 class GameSession {
     public:
         using ExitSignal = boost::signals2::signal<void(const std::vector<DTO::ExitPlayer>& exit_players)>;
-        using DogIdHasher = util::TaggedHasher<Dog::Id>;
-        explicit GameSession(const std::shared_ptr<Map> map, loot_gen::LootGenerator loot_gen, int64_t dog_retirement_time,  bool randomize_spawn_points) 
+        // Все обращения к состоянию сессии выполняются внутри её strand
+        using Strand = boost::asio::strand<boost::asio::thread_pool::executor_type>;
+        // Сколько наборов изменений хранится в снимке для ответов с ?since
+        static constexpr size_t CHANGES_HISTORY_SIZE = 64;
+
+        explicit GameSession(const std::shared_ptr<Map> map, loot_gen::LootGenerator loot_gen, int64_t dog_retirement_time,  bool randomize_spawn_points, Strand strand) 
             : map_{map}
             , loot_gen_{loot_gen}
             , randomize_spawn_points_{randomize_spawn_points} 
-            , dog_retirement_time_{dog_retirement_time} {
+            , dog_retirement_time_{dog_retirement_time}
+            , strand_{std::move(strand)}
+            , actions_{ACTIONS_RESERVE}
+            , snapshot_{std::make_shared<const SessionSnapshot>()} {
         }
 
         Dog& AddDog(const std::string& name);
         void DeleteDog(const Dog::Id& dog_id);
         const std::shared_ptr<Map> GetMap() const;
         const std::vector<Loot>& GetLootInMap() const;
-        const std::unordered_map<Dog::Id, Dog, DogIdHasher>& GetDogs() const;
-        std::unordered_map<Dog::Id, Dog, DogIdHasher>& GetDogs();
+        // nullptr, если собаки с таким id нет
+        Dog* FindDog(const Dog::Id& dog_id);
+        size_t GetDogsCount() const;
+        // Обход собак в порядке слотов
+        template <typename Fn>
+        void ForEachDog(Fn&& fn) const {
+            for (DogStore::Slot slot = 0; slot < dog_store_.Size(); ++slot) {
+                fn(dog_store_.GetDog(slot));
+            }
+        }
         uint64_t GetCounterDogId() const;
         void Tick(int64_t time_delta);
-        void Restore(const std::vector<Dog> dogs, const std::vector<Loot>& loot_in_map, uint64_t next_dog_id);
+        // Можно вызывать из любого потока без strand
+        std::shared_ptr<const SessionSnapshot> GetSnapshot() const {
+            return std::atomic_load(&snapshot_);
+        }
+        // Публикует снимок текущего состояния, если оно изменилось с прошлого снимка. Вызывается внутри strand
+        void PublishSnapshot();
+        // Можно вызывать из любого потока. Команды применяются в начале следующего тика в порядке поступления
+        void PushAction(const DogAction& action);
+        // Очищает сессию перед восстановлением собак через RestoreDog
+        void Restore(const std::vector<Loot>& loot_in_map, uint64_t next_dog_id);
+        Dog& RestoreDog(const Dog::Id& dog_id, const std::string& name, double max_speed, size_t bag_capacity);
         boost::signals2::connection DoExit(const ExitSignal::slot_type& handler) {
             return exit_signal_.connect(handler);
         }
+
+        Strand& GetStrand() {
+            return strand_;
+        }
     private:
         const std::shared_ptr<Map> map_;
         uint64_t counter_dog_id_ = 0;
-        std::unordered_map<Dog::Id, Dog, DogIdHasher> dogs_;
+        // Владеет собаками сессии, обращение к собаке по слоту - без поиска по id
+        DogStore dog_store_;
         std::vector<Loot> loot_in_map_;
         loot_gen::LootGenerator loot_gen_;
         const int64_t dog_retirement_time_;
         bool randomize_spawn_points_;
         ExitSignal exit_signal_;
         std::atomic<int> loot_id_counter_ = 0;
+        Strand strand_;
+        // Команды игроков (много писателей, один читатель — тик сессии)
+        boost::lockfree::queue<DogAction> actions_;
+        std::atomic<uint64_t> actions_pushed_ = 0;
+        uint64_t actions_popped_ = 0;
+        // Читается и заменяется через std::atomic_load/atomic_store
+        std::shared_ptr<const SessionSnapshot> snapshot_;
+
+        //Буферы обработки тика, переиспользуются между тиками
+        std::vector<std::pair<Dog::Id, VecMove>> dogs_moves_;
+        std::vector<collision_detector::Item> loot_items_;
+        std::vector<collision_detector::Gatherer> gatherers_;
+        collision_detector::ItemGrid loot_grid_;
+        std::vector<collision_detector::GatheringEvent> loot_events_;
+        std::vector<collision_detector::GatheringEvent> office_events_;
+        std::vector<char> collected_loot_;
+        std::vector<Dog::Id> retired_dogs_;
+        // Собаки, добавленные после последнего снимка
+        std::vector<Dog::Id> new_dogs_;
+        // Собаки прежнего снимка и новые в порядке id
+        struct SnapshotEntry {
+            Dog::Id id;
+            // Запись прежнего снимка, nullptr для новой собаки
+            const DogSnapshot* old = nullptr;
+            // nullptr, если собака ушла
+            const Dog* dog = nullptr;
+        };
+        std::vector<SnapshotEntry> snapshot_order_;
         
     private:
-        std::pair<Dog::Id,VecMove> MoveDog(Dog& dog, int64_t time_delta);
+        static constexpr size_t ACTIONS_RESERVE = 1024;
+
+        void ApplyActions();
+        void MergeSnapshotOrder(const SessionSnapshot& prev);
+        SessionChanges CollectChanges(const SessionSnapshot& prev) const;
+        void MoveDogs(int64_t time_delta);
         Position HandleCollisionsWall(Direction dir, Position start, Position end);
         Position GetRandomStartPos() const;
         void GenerateLoot(int64_t time_delta);
@@ -285,7 +403,8 @@ public:
     using TickSignal = boost::signals2::signal<void(int64_t)>;
     using MapIdHasher = util::TaggedHasher<Map::Id>;
     explicit Game (loot_gen::LootGenerator loot_gen, double defaul_dog_speed, size_t default_bag_capacity, int64_t dog_retirement_time, bool randomize_spawn_points) 
-        : loot_gen_{std::move(loot_gen)}
+        : tick_pool_{std::make_unique<boost::asio::thread_pool>(GetTickThreadsCount())}
+        , loot_gen_{std::move(loot_gen)}
         , default_dog_speed_{defaul_dog_speed}
         , default_bag_capacity_{default_bag_capacity}
         , dog_retirement_time_{dog_retirement_time}
@@ -310,6 +429,8 @@ public:
     double GetDefaultSpeed() const;
     size_t GetDefaultBagCapacity() const;
     void Tick(int64_t time_delta);
+    // Выполняет fn для каждой сессии внутри её strand и дожидается завершения всех вызовов
+    void RunInSessions(const std::function<void(GameSession&)>& fn);
     const std::unordered_map<Map::Id, GameSession, MapIdHasher>& GetSessions() const;
     std::unordered_map<Map::Id, GameSession, MapIdHasher>& GetSessions();
 
@@ -320,6 +441,9 @@ public:
 private:
     using MapIdToIndex = std::unordered_map<Map::Id, size_t, MapIdHasher>;
 
+    // Пул потоков, на котором работают strand всех сессий. Объявлен первым,
+    // чтобы разрушаться после сессий
+    std::unique_ptr<boost::asio::thread_pool> tick_pool_;
     Maps maps_;
     MapIdToIndex map_id_to_index_;
     std::unordered_map<Map::Id, GameSession, MapIdHasher> session_;
@@ -331,6 +455,7 @@ private:
     TickSignal tick_signal_;
 private:
     void AddSession(const std::shared_ptr<Map> map);
+    static size_t GetTickThreadsCount();
 };
 
 }  // namespace model
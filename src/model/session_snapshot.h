@@ -0,0 +1,60 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dog.h"
+#include "geometry.h"
+
+
+namespace model {
+
+    struct DogSnapshot {
+        Dog::Id id;
+        Position pos;
+        Speed speed;
+        Direction dir;
+        Dog::Bag bag;
+        int score = 0;
+    };
+
+    // Изменения между версиями снимка version - 1 и version
+    struct SessionChanges {
+        uint64_t version = 0;
+        // Новые и изменившиеся собаки (позиция, скорость, направление, рюкзак или очки)
+        std::vector<Dog::Id> changed_dogs;
+        std::vector<Dog::Id> removed_dogs;
+        // id появившегося и подобранного лута
+        std::vector<int> added_loot;
+        std::vector<int> removed_loot;
+    };
+
+    /*
+     * Неизменяемый снимок сессии, публикуемый после каждого тика.
+     * Читается из любого потока без захода в strand сессии.
+     */
+    struct SessionSnapshot {
+        // Растёт при каждой публикации снимка
+        uint64_t version = 0;
+        // Отсортированы по id
+        std::vector<DogSnapshot> dogs;
+        // Упорядочен по id
+        std::vector<Loot> loot_in_map;
+        // Последние наборы изменений, от старых к новым. Последний имеет ту же версию, что и снимок
+        std::vector<std::shared_ptr<const SessionChanges>> history;
+
+        const DogSnapshot* FindDog(const Dog::Id& id) const {
+            auto it = std::lower_bound(dogs.begin(), dogs.end(), id, [](const DogSnapshot& dog, const Dog::Id& id) {
+                return *dog.id < *id;
+            });
+
+            if (it == dogs.end() || it->id != id) {
+                return nullptr;
+            }
+
+            return &*it;
+        }
+    };
+
+} //namespace model
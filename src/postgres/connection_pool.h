@@ -0,0 +1,100 @@
+#pragma once
+#include <pqxx/connection>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace postgres {
+    /*
+     * Пул соединений фиксированного размера. Соединение выдаётся в
+     * ConnectionWrapper и возвращается в пул при его разрушении. Если
+     * свободных соединений нет, GetConnection ждёт не дольше timeout.
+     * Тип соединения - параметр шаблона, чтобы пул можно было проверить без базы
+     */
+    template <typename Connection>
+    class BasicConnectionPool {
+        using PoolType = BasicConnectionPool;
+        using ConnectionPtr = std::shared_ptr<Connection>;
+    public:
+        class ConnectionWrapper {
+        public:
+            ConnectionWrapper(ConnectionPtr&& conn, PoolType& pool) noexcept
+                : conn_{std::move(conn)}
+                , pool_{&pool} {
+            }
+
+            ConnectionWrapper(const ConnectionWrapper&) = delete;
+            ConnectionWrapper& operator=(const ConnectionWrapper&) = delete;
+
+            ConnectionWrapper(ConnectionWrapper&&) = default;
+            ConnectionWrapper& operator=(ConnectionWrapper&&) = default;
+
+            Connection& operator*() const& noexcept {
+                return *conn_;
+            }
+            Connection& operator*() const&& = delete;
+
+            Connection* operator->() const& noexcept {
+                return conn_.get();
+            }
+
+            ~ConnectionWrapper() {
+                if (conn_) {
+                    pool_->ReturnConnection(std::move(conn_));
+                }
+            }
+        private:
+            ConnectionPtr conn_;
+            PoolType* pool_;
+        };
+
+        // Фабрика создаёт соединение и регистрирует на нём подготовленные запросы
+        using ConnectionFactory = std::function<ConnectionPtr()>;
+
+        BasicConnectionPool(size_t capacity, const ConnectionFactory& connection_factory) {
+            pool_.reserve(capacity);
+            for (size_t i = 0; i < capacity; ++i) {
+                pool_.emplace_back(connection_factory());
+            }
+        }
+
+        // Выбрасывает std::runtime_error, если соединение не освободилось за timeout
+        ConnectionWrapper GetConnection(std::chrono::milliseconds timeout) {
+            std::unique_lock lock{mutex_};
+            // Ждём, пока какое-нибудь соединение вернётся в пул
+            const bool available = cond_var_.wait_for(lock, timeout, [this] {
+                return used_connections_ < pool_.size();
+            });
+            if (!available) {
+                throw std::runtime_error("Database connection pool timeout");
+            }
+
+            // После выхода из цикла ожидания мьютекс остаётся захваченным
+            return {std::move(pool_[used_connections_++]), *this};
+        }
+    private:
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        std::vector<ConnectionPtr> pool_;
+        size_t used_connections_ = 0;
+    private:
+        void ReturnConnection(ConnectionPtr&& conn) {
+            // Возвращаем соединение обратно в пул
+            {
+                std::lock_guard lock{mutex_};
+                assert(used_connections_ != 0);
+                pool_[--used_connections_] = std::move(conn);
+            }
+            // Уведомляем один из ожидающих потоков об изменении состояния пула
+            cond_var_.notify_one();
+        }
+    };
+
+    using ConnectionPool = BasicConnectionPool<pqxx::connection>;
+} // namespace postgres
@@ -0,0 +1,225 @@
+#include "local_store.h"
+#include "binary_writer.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace postgres {
+    using namespace std::literals;
+
+    namespace detail {
+        void WriteRecord(binary::Writer& writer, const DTO::Score& score) {
+            writer.WriteString(score.id);
+            writer.WriteString(score.name);
+            writer.WriteSigned(score.score);
+            writer.WriteSigned(score.play_time_ms);
+        }
+
+        DTO::Score ReadRecord(binary::Reader& reader) {
+            DTO::Score score;
+            score.id = reader.ReadString();
+            score.name = reader.ReadString();
+            score.score = reader.ReadSigned();
+            score.play_time_ms = reader.ReadSigned();
+            return score;
+        }
+
+        void CheckPage(int limit, int offset) {
+            if (limit < 0 || offset < 0) {
+                throw std::invalid_argument("Negative limit or offset");
+            }
+        }
+    } // namespace detail
+
+    LocalScoresRepository::LocalScoresRepository(const LocalScoreStore& store)
+        : store_{store} {
+    }
+
+    void LocalScoresRepository::Save(const DTO::Score& score) {
+        pending_.push_back(score);
+    }
+
+    void LocalScoresRepository::SaveBatch(const std::vector<DTO::Score>& scores) {
+        pending_.insert(pending_.end(), scores.begin(), scores.end());
+    }
+
+    std::vector<DTO::Score> LocalScoresRepository::GetScores(int limit, int offset) const {
+        return store_.GetScores(limit, offset);
+    }
+
+    std::vector<DTO::Score> LocalScoresRepository::GetScoresAfter(const DTO::Score& after, int limit) const {
+        return store_.GetScoresAfter(after, limit);
+    }
+
+    std::vector<DTO::Score>& LocalScoresRepository::GetPending() {
+        return pending_;
+    }
+
+    LocalUnitOfWork::LocalUnitOfWork(LocalScoreStore& store)
+        : store_{store}
+        , scores_{store} {
+    }
+
+    ScoresRepository& LocalUnitOfWork::GetScores() {
+        return scores_;
+    }
+
+    void LocalUnitOfWork::Commit() {
+        auto& pending = scores_.GetPending();
+        if (!pending.empty()) {
+            store_.Append(pending);
+            pending.clear();
+        }
+    }
+
+    void LocalUnitOfWork::RollBack() {
+        scores_.GetPending().clear();
+    }
+
+    LocalUnitOfWorkFactory::LocalUnitOfWorkFactory(LocalScoreStore& store)
+        : store_{store} {
+    }
+
+    std::unique_ptr<UnitOfWork> LocalUnitOfWorkFactory::CreateUnitOfWork() {
+        return std::make_unique<LocalUnitOfWork>(store_);
+    }
+
+    LocalScoreStore::LocalScoreStore(std::filesystem::path path)
+        : path_{std::move(path)}
+        , factory_uow_{*this} {
+        LoadAndCompact();
+        OpenLog();
+    }
+
+    UnitOfWorkFactory& LocalScoreStore::GetFactory() & {
+        return factory_uow_;
+    }
+
+    void LocalScoreStore::Append(const std::vector<DTO::Score>& scores) {
+        binary::Writer writer;
+        for (const auto& score : scores) {
+            detail::WriteRecord(writer, score);
+        }
+        const auto data = writer.Release();
+
+        std::unique_lock lock{mtx_};
+        log_.write(data.data(), static_cast<std::streamsize>(data.size()));
+        log_.flush();
+        if (!log_) {
+            // Недописанная пачка обрезается, иначе следующие записи не прочитаются при запуске
+            log_.close();
+            std::error_code ec;
+            std::filesystem::resize_file(path_, log_size_, ec);
+            OpenLog();
+            throw std::runtime_error("Can't write score log: " + path_.string());
+        }
+        log_size_ += data.size();
+
+        // Пачка сортируется отдельно и сливается с индексом за один проход
+        const auto middle = static_cast<std::ptrdiff_t>(index_.size());
+        index_.insert(index_.end(), scores.begin(), scores.end());
+        std::sort(index_.begin() + middle, index_.end(), DTO::ScoreOrder{});
+        std::inplace_merge(index_.begin(), index_.begin() + middle, index_.end(), DTO::ScoreOrder{});
+    }
+
+    std::vector<DTO::Score> LocalScoreStore::GetScores(int limit, int offset) const {
+        detail::CheckPage(limit, offset);
+        std::shared_lock lock{mtx_};
+        const auto begin = std::min(static_cast<size_t>(offset), index_.size());
+        const auto end = std::min(begin + static_cast<size_t>(limit), index_.size());
+        return {index_.begin() + begin, index_.begin() + end};
+    }
+
+    std::vector<DTO::Score> LocalScoreStore::GetScoresAfter(const DTO::Score& after, int limit) const {
+        detail::CheckPage(limit, 0);
+        std::shared_lock lock{mtx_};
+        auto begin = std::upper_bound(index_.begin(), index_.end(), after, DTO::ScoreOrder{});
+        auto count = std::min(static_cast<size_t>(limit), static_cast<size_t>(index_.end() - begin));
+        return {begin, begin + count};
+    }
+
+    size_t LocalScoreStore::Size() const {
+        std::shared_lock lock{mtx_};
+        return index_.size();
+    }
+
+    void LocalScoreStore::LoadAndCompact() {
+        std::string data;
+        if (std::filesystem::exists(path_)) {
+            std::ifstream ifs{path_, std::ios::in | std::ios::binary};
+            if (!ifs.good()) {
+                throw std::runtime_error("Can't open file: " + path_.string());
+            }
+            data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+
+        size_t torn_bytes = 0;
+        if (!data.empty()) {
+            if (!std::string_view(data).starts_with(MAGIC)) {
+                // Чужой файл не переписываем
+                throw std::runtime_error("Not a score log: " + path_.string());
+            }
+
+            binary::Reader reader{std::string_view(data).substr(MAGIC.size())};
+            size_t consumed = MAGIC.size();
+            try {
+                while (!reader.AtEnd()) {
+                    index_.push_back(detail::ReadRecord(reader));
+                    consumed = data.size() - reader.Remaining();
+                }
+            } catch (const std::out_of_range&) {
+                // Процесс завершился посреди записи пачки
+                torn_bytes = data.size() - consumed;
+            }
+        }
+
+        const size_t loaded = index_.size();
+        std::sort(index_.begin(), index_.end(), DTO::ScoreOrder{});
+        // Повторы одного рекорда совпадают во всех полях и после сортировки стоят рядом
+        index_.erase(std::unique(index_.begin(), index_.end(), [](const DTO::Score& lhs, const DTO::Score& rhs) {
+            return lhs.id == rhs.id;
+        }), index_.end());
+
+        binary::Writer writer;
+        for (const auto& score : index_) {
+            detail::WriteRecord(writer, score);
+        }
+        const auto compacted = std::string(MAGIC) + writer.Release();
+
+        if (!path_.parent_path().empty()) {
+            std::filesystem::create_directories(path_.parent_path());
+        }
+        auto temp_path = path_;
+        temp_path += ".tmp"s;
+        {
+            std::ofstream ofs{temp_path, std::ios::out | std::ios::binary | std::ios::trunc};
+            ofs.write(compacted.data(), static_cast<std::streamsize>(compacted.size()));
+            ofs.close();
+            if (!ofs) {
+                std::error_code ec;
+                std::filesystem::remove(temp_path, ec);
+                throw std::runtime_error("Can't write file: " + temp_path.string());
+            }
+        }
+        std::filesystem::rename(temp_path, path_);
+        log_size_ = compacted.size();
+
+        logger::Logger::LogInfo("score log compacted"sv,
+            "file"sv, path_.string(),
+            "records"sv, index_.size(),
+            "duplicates"sv, loaded - index_.size(),
+            "torn_bytes"sv, torn_bytes
+        );
+    }
+
+    void LocalScoreStore::OpenLog() {
+        log_.open(path_, std::ios::out | std::ios::binary | std::ios::app);
+        if (!log_.good()) {
+            throw std::runtime_error("Can't open file: " + path_.string());
+        }
+    }
+} // namespace postgres
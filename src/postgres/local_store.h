@@ -0,0 +1,91 @@
+#pragma once
+#include "repository.h"
+#include "unit_of_work.h"
+#include <filesystem>
+#include <fstream>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+
+namespace postgres {
+    class LocalScoreStore;
+
+    // Записи копятся в транзакции и попадают в хранилище при Commit
+    class LocalScoresRepository : public ScoresRepository {
+    public:
+        explicit LocalScoresRepository(const LocalScoreStore& store);
+
+        void Save(const DTO::Score& score) override;
+        void SaveBatch(const std::vector<DTO::Score>& scores) override;
+        std::vector<DTO::Score> GetScores(int limit, int offset) const override;
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const override;
+
+        std::vector<DTO::Score>& GetPending();
+    private:
+        const LocalScoreStore& store_;
+        std::vector<DTO::Score> pending_;
+    };
+
+    class LocalUnitOfWork : public UnitOfWork {
+    public:
+        explicit LocalUnitOfWork(LocalScoreStore& store);
+
+        ScoresRepository& GetScores() override;
+
+        // Выбрасывает std::runtime_error, если записи не удалось дописать в файл
+        void Commit() override;
+        void RollBack() override;
+    private:
+        LocalScoreStore& store_;
+        LocalScoresRepository scores_;
+    };
+
+    class LocalUnitOfWorkFactory : public UnitOfWorkFactory {
+    public:
+        explicit LocalUnitOfWorkFactory(LocalScoreStore& store);
+
+        std::unique_ptr<UnitOfWork> CreateUnitOfWork() override;
+    private:
+        LocalScoreStore& store_;
+    };
+
+    /*
+     * Рекорды в локальном файле вместо PostgreSQL, для запуска на одном узле
+     * и замеров без внешней базы. Файл - журнал, в который рекорды только
+     * дописываются, а все рекорды держатся в памяти в порядке выдачи
+     * (DTO::ScoreOrder), поэтому запросы страниц в файл не обращаются.
+     * При запуске журнал уплотняется: недописанный хвост и повторы одного
+     * рекорда (после повторной записи пачки) отбрасываются, а файл
+     * переписывается целиком через временный файл
+     */
+    class LocalScoreStore {
+    public:
+        // Выбрасывает std::runtime_error, если файл не открывается или это не журнал рекордов
+        explicit LocalScoreStore(std::filesystem::path path);
+
+        LocalScoreStore(const LocalScoreStore&) = delete;
+        LocalScoreStore& operator=(const LocalScoreStore&) = delete;
+
+        UnitOfWorkFactory& GetFactory() &;
+
+        // Дописывает рекорды в журнал и в индекс. При ошибке записи файл возвращается к прежнему размеру
+        void Append(const std::vector<DTO::Score>& scores);
+        std::vector<DTO::Score> GetScores(int limit, int offset) const;
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const;
+        size_t Size() const;
+    private:
+        std::filesystem::path path_;
+        mutable std::shared_mutex mtx_;
+        std::vector<DTO::Score> index_;
+        std::ofstream log_;
+        uintmax_t log_size_ = 0;
+        LocalUnitOfWorkFactory factory_uow_;
+    private:
+        // Заголовок файла, по нему журнал отличается от чужого файла
+        static constexpr std::string_view MAGIC = "SCORELOG1\n";
+
+        void LoadAndCompact();
+        void OpenLog();
+    };
+} // namespace postgres
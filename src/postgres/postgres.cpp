@@ -1,4 +1,7 @@
 #include "postgres.h"
+#include "logger.h"
+
+#include <vector>
 
 
 namespace postgres {
@@ -6,11 +9,35 @@ namespace postgres {
     using pqxx::operator"" _zv;
 
     namespace detail {
+        using Migration = std::vector<pqxx::zview>;
+
+        /*
+         * Изменения схемы после CreateTabels, по одному на версию. Каждое выполняется
+         * один раз: номер последнего применённого хранится в schema_version.
+         * Новые изменения только дописываются в конец
+         */
+        const std::vector<Migration> MIGRATIONS = {
+            // 1. Индекс для постраничного чтения по курсору (get_scores_after). score входит
+            // со знаком минус, чтобы у всех колонок было одно направление и подходило сравнение
+            // строк целиком. Имена сравниваются побайтово (COLLATE "C"), как в DTO::ScoreOrder,
+            // иначе порядок зависит от локали базы и расходится с кэшем таблицы рекордов.
+            // Он же обслуживает get_scores, поэтому score_idx больше не нужен
+            {
+                R"(
+                CREATE INDEX IF NOT EXISTS score_keyset_c_idx ON retired_players ((-score), play_time_ms, name COLLATE "C", id)
+                )"_zv,
+                R"(
+                DROP INDEX IF EXISTS score_idx
+                )"_zv
+            }
+        };
+
         DTO::Score ScoreFromRow(const pqxx::row& row, size_t start_index) {
             return DTO::Score{
                 .name = row[start_index++].as<std::string>(),
                 .score = row[start_index++].as<int64_t>(),
-                .play_time_ms = row[start_index++].as<int64_t>()
+                .play_time_ms = row[start_index++].as<int64_t>(),
+                .id = row[start_index++].as<std::string>()
             };
         }
     } // namespace detail
@@ -20,14 +47,24 @@ namespace postgres {
     }
 
     void ScoresRepositoryImpl::Save(const DTO::Score& score) {
-        //Генерации id делигорована СУБД
+        // id генерирует приложение, поэтому курсор рекорда из кэша строится без чтения из базы
         transaction_.exec_prepared("add_score",
+            score.id,
             score.name,
             score.score,
             score.play_time_ms
         );
     }
 
+    void ScoresRepositoryImpl::SaveBatch(const std::vector<DTO::Score>& scores) {
+        // Пачка передаётся одной командой COPY вместо отдельного INSERT на каждую запись
+        auto stream = pqxx::stream_to::table(transaction_, {"retired_players"sv}, {"id"sv, "name"sv, "score"sv, "play_time_ms"sv});
+        for (const auto& score : scores) {
+            stream.write_values(score.id, score.name, score.score, score.play_time_ms);
+        }
+        stream.complete();
+    }
+
     std::vector<DTO::Score> ScoresRepositoryImpl::GetScores(int limit, int offset) const {
         std::vector<DTO::Score> scores;
         auto result = transaction_.exec_prepared("get_scores", limit, offset);
@@ -37,8 +74,18 @@ namespace postgres {
         return scores;
     }
 
-    UnitOfWorkImpl::UnitOfWorkImpl(pqxx::connection& connection) 
-        : work_{connection} 
+    std::vector<DTO::Score> ScoresRepositoryImpl::GetScoresAfter(const DTO::Score& after, int limit) const {
+        std::vector<DTO::Score> scores;
+        auto result = transaction_.exec_prepared("get_scores_after", after.score, after.play_time_ms, after.name, after.id, limit);
+        for (const auto& row : result) {
+            scores.push_back(detail::ScoreFromRow(row, 0));
+        }
+        return scores;
+    }
+
+    UnitOfWorkImpl::UnitOfWorkImpl(ConnectionPool::ConnectionWrapper connection) 
+        : connection_{std::move(connection)}
+        , work_{*connection_} 
         , scores_{work_} {
     }
 
@@ -54,27 +101,36 @@ namespace postgres {
         work_.abort();
     }
 
-    UnitOfWorkFactoryImpl::UnitOfWorkFactoryImpl(pqxx::connection& connection) 
-        : connection_{connection} {
+    UnitOfWorkFactoryImpl::UnitOfWorkFactoryImpl(ConnectionPool& pool, std::chrono::milliseconds checkout_timeout) 
+        : pool_{pool}
+        , checkout_timeout_{checkout_timeout} {
     }
 
     std::unique_ptr<UnitOfWork> UnitOfWorkFactoryImpl::CreateUnitOfWork() {
-        return std::make_unique<UnitOfWorkImpl>(connection_);
+        return std::make_unique<UnitOfWorkImpl>(pool_.GetConnection(checkout_timeout_));
     }
 
-    DataBase::DataBase(pqxx::connection connection) 
-        : connection_{std::move(connection)} 
-        , factory_uow_{connection_} {
-        CreateTabels();
-        PrepareTransaction();
+    DataBase::DataBase(const std::string& url, DataBaseSettings settings) 
+        : pool_{settings.pool_size, [&url, tables_created = false]() mutable {
+            auto connection = std::make_shared<pqxx::connection>(url);
+            // Запросы готовятся на сервере, поэтому таблица должна существовать до этого
+            if (!tables_created) {
+                CreateTabels(*connection);
+                Migrate(*connection);
+                tables_created = true;
+            }
+            PrepareScore(*connection);
+            return connection;
+        }}
+        , factory_uow_{pool_, settings.checkout_timeout} {
     }
 
     UnitOfWorkFactory& DataBase::GetFactory() & {
         return factory_uow_;
     }
 
-    void DataBase::CreateTabels() {
-        pqxx::work work{connection_};
+    void DataBase::CreateTabels(pqxx::connection& connection) {
+        pqxx::work work{connection};
         work.exec(R"(
         CREATE TABLE IF NOT EXISTS retired_players (
             id UUID DEFAULT gen_random_uuid() CONSTRAINT player_id_constraint PRIMARY KEY,
@@ -91,26 +147,65 @@ namespace postgres {
         work.commit();
     }
 
-    void DataBase::PrepareTransaction() {
-        //Инициализируем prepeare sql инъекции
-        PrepareScore();
+    void DataBase::Migrate(pqxx::connection& connection) {
+        pqxx::work work{connection};
+        // Серверы могут запускаться одновременно, изменения схемы применяет только один из них
+        work.exec(R"(
+        SELECT pg_advisory_xact_lock(hashtext('retired_players schema'))
+        )"_zv);
+        work.exec(R"(
+        CREATE TABLE IF NOT EXISTS schema_version (
+            version INT NOT NULL
+        );
+        )"_zv);
+
+        const auto applied = work.query_value<int>(R"(
+        SELECT COALESCE(MAX(version), 0) FROM schema_version
+        )"_zv);
+        for (int version = applied + 1; version <= static_cast<int>(detail::MIGRATIONS.size()); ++version) {
+            for (auto statement : detail::MIGRATIONS[version - 1]) {
+                work.exec(statement);
+            }
+            work.exec_params(R"(
+            INSERT INTO schema_version (version) VALUES ($1)
+            )"_zv, version);
+            logger::Logger::LogInfo("database migrated"sv,
+                "version"sv, version
+            );
+        }
+
+        work.commit();
     }
 
-    void DataBase::PrepareScore() {
-        connection_.prepare("add_score",
+    void DataBase::PrepareScore(pqxx::connection& connection) {
+        //Инициализируем prepeare sql инъекции
+        connection.prepare("add_score",
             R"(
-            INSERT INTO retired_players (name, score, play_time_ms)
-            VALUES ($1, $2, $3)
+            INSERT INTO retired_players (id, name, score, play_time_ms)
+            VALUES ($1, $2, $3, $4)
             )"_zv
         );
 
-        connection_.prepare("get_scores",
+        connection.prepare("get_scores",
             R"(
-            SELECT name, score, play_time_ms
+            SELECT name, score, play_time_ms, id
             FROM retired_players
-            ORDER BY score DESC, play_time_ms, name
+            ORDER BY -score, play_time_ms, name COLLATE "C", id
             LIMIT $1 OFFSET $2
             )"_zv
         );
+
+        // Сравнение строк целиком (row value) сводится к поиску по score_keyset_c_idx,
+        // поэтому глубина страницы не влияет на время запроса, в отличие от OFFSET.
+        // score по убыванию, поэтому в индексе и в сравнении стоит -score
+        connection.prepare("get_scores_after",
+            R"(
+            SELECT name, score, play_time_ms, id
+            FROM retired_players
+            WHERE (-score, play_time_ms, name COLLATE "C", id) > (-($1::int), $2::int, $3::varchar COLLATE "C", $4::uuid)
+            ORDER BY -score, play_time_ms, name COLLATE "C", id
+            LIMIT $5
+            )"_zv
+        );
     }
 } // namespace postgres
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <pqxx/pqxx>
 #include "repository.h"
 #include "unit_of_work.h"
+#include "connection_pool.h"
+#include <chrono>
 #include <string>
 
 
@@ -12,44 +14,62 @@ namespace postgres {
         explicit ScoresRepositoryImpl(pqxx::transaction_base& transaction);
 
         void Save(const DTO::Score& score) override;
+        void SaveBatch(const std::vector<DTO::Score>& scores) override;
         std::vector<DTO::Score> GetScores(int limit, int offset) const override;
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const override;
     private:
         pqxx::transaction_base& transaction_;
     };
 
+    // Транзакция на соединении из пула. Соединение возвращается в пул вместе с разрушением UnitOfWork
     class UnitOfWorkImpl : public UnitOfWork {
     public:
-        explicit UnitOfWorkImpl(pqxx::connection& connection);
+        explicit UnitOfWorkImpl(ConnectionPool::ConnectionWrapper connection);
 
         ScoresRepository& GetScores() override;
 
         void Commit() override;
         void RollBack() override;
     private:
+        ConnectionPool::ConnectionWrapper connection_;
         pqxx::work work_;
         ScoresRepositoryImpl scores_;
     };
 
     class UnitOfWorkFactoryImpl : public UnitOfWorkFactory {
     public:
-        explicit UnitOfWorkFactoryImpl(pqxx::connection& connection);
+        UnitOfWorkFactoryImpl(ConnectionPool& pool, std::chrono::milliseconds checkout_timeout);
 
+        // Выбрасывает std::runtime_error, если все соединения заняты дольше checkout_timeout
         std::unique_ptr<UnitOfWork> CreateUnitOfWork() override;
     private:
-        pqxx::connection& connection_;
+        ConnectionPool& pool_;
+        std::chrono::milliseconds checkout_timeout_;
     };
 
+    struct DataBaseSettings {
+        size_t pool_size = 4;
+        std::chrono::milliseconds checkout_timeout{5000};
+    };
+
+    /*
+     * Таблицы создаются при запуске на первом соединении, там же применяются
+     * ещё не выполненные изменения схемы (Migrate), подготовленные
+     * запросы регистрируются на каждом соединении пула, поэтому чтение рекордов
+     * и их запись идут параллельно через разные соединения
+     */
     class DataBase {
     public:
-        explicit DataBase(pqxx::connection connection);
+        DataBase(const std::string& url, DataBaseSettings settings);
 
         UnitOfWorkFactory& GetFactory() &;
     private:
-        pqxx::connection connection_;
+        ConnectionPool pool_;
         UnitOfWorkFactoryImpl factory_uow_;
     private:
-        void CreateTabels();
-        void PrepareTransaction();
-        void PrepareScore();
+        static void CreateTabels(pqxx::connection& connection);
+        // Применяет изменения схемы, которых ещё нет в таблице schema_version
+        static void Migrate(pqxx::connection& connection);
+        static void PrepareScore(pqxx::connection& connection);
     };
 } // namespace postgres
\ No newline at end of file
@@ -6,6 +6,9 @@ namespace postgres {
     class ScoresRepository {
     public:
         virtual void Save(const DTO::Score& score) = 0;
+        virtual void SaveBatch(const std::vector<DTO::Score>& scores) = 0;
         virtual std::vector<DTO::Score> GetScores(int limit, int offset) const = 0;
+        // Рекорды, следующие за after в порядке выдачи
+        virtual std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const = 0;
     };
 } // namespace postgres
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "score_writer.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+namespace postgres {
+    using namespace std::literals;
+
+    ScoreWriter::ScoreWriter(UseCases& use_cases, ScoreWriterSettings settings, SavedHandler on_saved)
+        : use_cases_{use_cases}
+        , settings_{settings}
+        , on_saved_{std::move(on_saved)} {
+        writer_ = std::thread([this] {
+            Run();
+        });
+    }
+
+    ScoreWriter::~ScoreWriter() {
+        Stop();
+    }
+
+    bool ScoreWriter::Push(DTO::Score score) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (queue_.size() >= settings_.max_queue_size) {
+            lock.unlock();
+            // Рекорд остаётся хотя бы в логе
+            logger::Logger::LogError("score dropped"sv,
+                "name"sv, score.name,
+                "score"sv, score.score,
+                "play_time_ms"sv, score.play_time_ms
+            );
+            return false;
+        }
+
+        queue_.push_back(std::move(score));
+        queue_depth_.store(queue_.size(), std::memory_order_relaxed);
+        if (queue_.size() >= settings_.max_batch_size) {
+            wake_.notify_one();
+        }
+        return true;
+    }
+
+    void ScoreWriter::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (stopped_) {
+                return;
+            }
+            stopped_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+    }
+
+    size_t ScoreWriter::GetQueueDepth() const {
+        return queue_depth_.load(std::memory_order_relaxed);
+    }
+
+    void ScoreWriter::Run() {
+        // Ноль, пока база отвечает
+        std::chrono::milliseconds retry_delay{0};
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                // После ошибки полная пачка не будит поток, иначе он крутится в цикле повторов
+                const bool failing = retry_delay.count() > 0;
+                wake_.wait_for(lock, failing ? retry_delay : settings_.flush_interval, [this, failing] {
+                    return stopped_ || (!failing && queue_.size() >= settings_.max_batch_size);
+                });
+                if (stopped_) {
+                    break;
+                }
+            }
+
+            // Пока набираются полные пачки, пишем без ожидания
+            bool saved = Flush();
+            while (saved && GetQueueDepth() >= settings_.max_batch_size) {
+                saved = Flush();
+            }
+
+            if (saved) {
+                retry_delay = std::chrono::milliseconds{0};
+            } else if (retry_delay.count() == 0) {
+                retry_delay = settings_.retry_delay;
+            } else {
+                retry_delay = std::min(retry_delay * 2, settings_.max_retry_delay);
+            }
+        }
+
+        // При остановке дописываем очередь, пока база отвечает
+        while (GetQueueDepth() > 0 && Flush()) {
+        }
+
+        if (auto lost = GetQueueDepth(); lost > 0) {
+            logger::Logger::LogError("scores not saved"sv,
+                "count"sv, lost
+            );
+        }
+    }
+
+    bool ScoreWriter::Flush() {
+        std::vector<DTO::Score> batch;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            const auto count = std::min(queue_.size(), settings_.max_batch_size);
+            batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.begin() + count));
+            queue_.erase(queue_.begin(), queue_.begin() + count);
+        }
+
+        if (batch.empty()) {
+            return true;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            use_cases_.AddScores(batch);
+        } catch (const std::exception& ex) {
+            logger::Logger::LogError("scores batch save failed"sv,
+                "count"sv, batch.size(),
+                "exception"sv, ex.what()
+            );
+
+            auto rejected = SaveEach(batch);
+            if (batch.empty()) {
+                // Возвращаем пачку в начало очереди, порядок рекордов сохраняется
+                std::lock_guard<std::mutex> lock(mtx_);
+                for (auto it = rejected.rbegin(); it != rejected.rend(); ++it) {
+                    queue_.push_front(std::move(it->first));
+                }
+                queue_depth_.store(queue_.size(), std::memory_order_relaxed);
+                logger::Logger::LogError("scores save failed"sv,
+                    "count"sv, rejected.size(),
+                    "queue_depth"sv, queue_.size(),
+                    "exception"sv, rejected.front().second
+                );
+                return false;
+            }
+
+            // База отвечает, значит отвергнутые рекорды не запишутся и при повторе.
+            // Они остаются только в логе
+            for (const auto& [score, error] : rejected) {
+                logger::Logger::LogError("score not saved"sv,
+                    "name"sv, score.name,
+                    "score"sv, score.score,
+                    "play_time_ms"sv, score.play_time_ms,
+                    "exception"sv, error
+                );
+            }
+        }
+
+        if (on_saved_) {
+            on_saved_(batch);
+        }
+
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        size_t depth = 0;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            depth = queue_.size();
+            queue_depth_.store(depth, std::memory_order_relaxed);
+        }
+        logger::Logger::LogInfo("scores saved"sv,
+            "count"sv, batch.size(),
+            "queue_depth"sv, depth,
+            "duration_ms"sv, duration.count()
+        );
+        return true;
+    }
+
+    std::vector<std::pair<DTO::Score, std::string>> ScoreWriter::SaveEach(std::vector<DTO::Score>& batch) {
+        std::vector<std::pair<DTO::Score, std::string>> rejected;
+        std::vector<DTO::Score> saved;
+        for (auto& score : batch) {
+            try {
+                use_cases_.AddScore(score);
+                saved.push_back(std::move(score));
+            } catch (const std::exception& ex) {
+                rejected.emplace_back(std::move(score), ex.what());
+            }
+        }
+        batch = std::move(saved);
+        return rejected;
+    }
+} // namespace postgres
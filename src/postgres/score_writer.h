@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "data_transfer_object.h"
+#include "use_cases.h"
+
+
+namespace postgres {
+    struct ScoreWriterSettings {
+        // Как часто накопленные рекорды записываются в базу
+        std::chrono::milliseconds flush_interval{500};
+        // Сколько рекордов записывается одной командой
+        size_t max_batch_size = 100;
+        // Сколько рекордов может ждать записи. Лишние отбрасываются с записью в лог
+        size_t max_queue_size = 10000;
+        // Пауза перед повтором после ошибки базы, удваивается с каждой ошибкой подряд до max_retry_delay
+        std::chrono::milliseconds retry_delay{1000};
+        std::chrono::milliseconds max_retry_delay{30000};
+    };
+
+    /*
+     * Отложенная запись рекордов. Push только кладёт рекорд в очередь, запись
+     * в базу выполняет отдельный поток пачками до max_batch_size раз в
+     * flush_interval (или сразу, как только набралась пачка). Поэтому
+     * медленная база не задерживает тик игры. Если пачка не записалась,
+     * рекорды пишутся по одному: не записавшиеся рекорды отбрасываются с
+     * записью в лог, чтобы один плохой рекорд не держал очередь. Если не
+     * записался ни один, база считается недоступной: пачка остаётся в
+     * очереди, а повтор выполняется через растущую паузу retry_delay
+     */
+    class ScoreWriter {
+    public:
+        // Вызывается из потока записи с рекордами, которые уже есть в базе
+        using SavedHandler = std::function<void(const std::vector<DTO::Score>&)>;
+
+        // use_cases и on_saved используются только из потока записи
+        ScoreWriter(UseCases& use_cases, ScoreWriterSettings settings, SavedHandler on_saved = {});
+        ~ScoreWriter();
+
+        ScoreWriter(const ScoreWriter&) = delete;
+        ScoreWriter& operator=(const ScoreWriter&) = delete;
+
+        // false, если очередь заполнена и рекорд отброшен
+        bool Push(DTO::Score score);
+        // Записывает оставшиеся рекорды и останавливает поток записи
+        void Stop();
+
+        // Метрика: число рекордов, ожидающих записи
+        size_t GetQueueDepth() const;
+    private:
+        UseCases& use_cases_;
+        const ScoreWriterSettings settings_;
+        const SavedHandler on_saved_;
+
+        std::mutex mtx_;
+        std::condition_variable wake_;
+        std::deque<DTO::Score> queue_;
+        std::atomic<size_t> queue_depth_ = 0;
+        bool stopped_ = false;
+        std::thread writer_;
+    private:
+        void Run();
+        // Пишет одну пачку. false, если база недоступна и пачка вернулась в очередь
+        bool Flush();
+        // Пишет рекорды по одному. В batch остаются записанные, не записавшиеся возвращаются с текстом ошибки
+        std::vector<std::pair<DTO::Score, std::string>> SaveEach(std::vector<DTO::Score>& batch);
+    };
+} // namespace postgres
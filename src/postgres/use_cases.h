@@ -6,7 +6,10 @@ namespace postgres {
     class UseCases {
     public:
         virtual void AddScore(const DTO::Score& score) = 0;
+        // Все записи сохраняются в одной транзакции
+        virtual void AddScores(const std::vector<DTO::Score>& scores) = 0;
         virtual std::vector<DTO::Score> GetScores(int limit, int offset) const = 0;
+        virtual std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const = 0;
     protected:
         ~UseCases() = default;
     };
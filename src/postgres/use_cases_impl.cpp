@@ -18,9 +18,27 @@ namespace postgres {
         }
     }
 
+    void UseCasesImpl::AddScores(const std::vector<DTO::Score>& scores) {
+        auto uow = factory_uow_.CreateUnitOfWork();
+        auto& repository = uow->GetScores();
+        try {
+            repository.SaveBatch(scores);
+            uow->Commit();
+        } catch (const std::exception&) {
+            uow->RollBack();
+            throw;
+        }
+    }
+
     std::vector<DTO::Score> UseCasesImpl::GetScores(int limit, int offset) const {
         auto uow = factory_uow_.CreateUnitOfWork();
         auto& scores = uow->GetScores();
         return scores.GetScores(limit, offset);
     }
+
+    std::vector<DTO::Score> UseCasesImpl::GetScoresAfter(const DTO::Score& after, int limit) const {
+        auto uow = factory_uow_.CreateUnitOfWork();
+        auto& scores = uow->GetScores();
+        return scores.GetScoresAfter(after, limit);
+    }
 } // namespace postgres
\ No newline at end of file
@@ -8,7 +8,9 @@ namespace postgres {
         explicit UseCasesImpl(UnitOfWorkFactory& factory_uow);
         
         void AddScore(const DTO::Score& score) override;
+        void AddScores(const std::vector<DTO::Score>& scores) override;
         std::vector<DTO::Score> GetScores(int limit, int offset) const override;
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score& after, int limit) const override;
     private:
         UnitOfWorkFactory& factory_uow_;
     };
@@ -1,9 +1,15 @@
 #include "api_handler.h"
+#include "state_json.h"
+#include "binary_encoding.h"
+#include "etag.h"
+#include "query_string.h"
+#include "records_cursor.h"
 
 #include <boost/json.hpp>
+#include <algorithm>
+#include <charconv>
 #include <optional>
 #include <string>
-#include <unordered_map>
 
 
 namespace json = boost::json;
@@ -92,96 +98,9 @@ namespace http_handler {
                 };
             }
 
-            json::array SerializePosition(model::Position pos) {
-                return json::array{pos.x, pos.y};
-            }
-
-            json::array SerializeSpeed(model::Speed speed) {
-                return json::array{speed.h_speed, speed.v_speed};
-            }
-
-            const std::string& SerializeDirection(model::Direction dir) {
-                static const std::string UP = "U"s;
-                static const std::string DOWN = "D"s;
-                static const std::string LEFT = "L"s;
-                static const std::string RIGHT = "R"s;
-                static const std::string UNKNOWN = "unknown dir"s;
-
-                switch (dir) {
-                case model::Direction::NORTH:
-                    return UP;
-                    break;
-                case model::Direction::SOUTH:
-                    return DOWN;
-                    break;
-                case model::Direction::WEST:
-                    return LEFT;
-                    break;
-                case model::Direction::EAST:
-                    return RIGHT;
-                    break;
-                default:
-                    return UNKNOWN;
-                    break;
-                }
-            }
-
-            json::object SerializeLootBag(const model::Loot& loot) {
-                return json::object{
-                    {"type", loot.type},
-                    {"id", loot.id}
-                };
-            }
-
-            json::object SerializeLootMap(const model::Loot& loot) {
-                return json::object{
-                    {"type", loot.type},
-                    {"pos", SerializePosition(loot.pos)}
-                };
-            }
-
-            json::array SerializeBag(const model::Dog::Bag& bag) {
-                json::array res;
-
-                for(const auto& loot : bag) {
-                    res.emplace_back(SerializeLootBag(loot));
-                }
-
-                return res;
-            }
-
-            json::object SerializeDog(const model::Dog* dog) {
-                if (dog == nullptr) {
-                    return json::object {
-                        {"pos", json::array{}},
-                        {"speed", json::array{}},
-                        {"dir", "unknown dir"s}
-                    };
-                }
-
-                return json::object {
-                    {"pos", SerializePosition(dog->GetPos())},
-                    {"speed", SerializeSpeed(dog->GetSpeed())},
-                    {"dir", SerializeDirection(dog->GetDir())},
-                    {"bag", SerializeBag(dog->GetBag())},
-                    {"score", dog->GetScore()}
-                };
-            }
-
-            json::object SerializeLootsMap(const std::vector<model::Loot>& loot_in_map) {
-                size_t size = loot_in_map.size();
-                json::object lost_object;
-
-                for (size_t i = 0; i < size; ++i) {
-                    lost_object[std::to_string(i)] = SerializeLootMap(loot_in_map[i]);
-                }
-
-                return lost_object;
-            }
-
         } //namespace serialize
 
-        std::string GetMaps(std::string_view target, const model::Game& game){
+        std::string GetMaps(const model::Game& game){
             json::array arr;
             for(const auto map : game.GetMaps()){
                 json::object obj {
@@ -194,16 +113,10 @@ namespace http_handler {
             return json::serialize(arr);
         }
 
-        std::optional<std::string> GetMap(std::string_view target, const model::Game& game, const extra_data::ExtraData& extra_data) {
-            auto id_str = std::string{target.substr(13)};
-            auto id = model::Map::Id{id_str};
-            const auto map = game.FindMap(id);
-            if(map == nullptr){
-                return std::nullopt;
-            }
-
-            auto map_json = serialize::SerializeMap(map, extra_data);
-            return json::serialize(map_json);
+        // Бинарный формат отдаётся только по явному запросу, по умолчанию - JSON
+        bool AcceptsBinary(const StringRequest& req) {
+            auto accept = req.find(http::field::accept);
+            return accept != req.end() && accept->value().find(ContentType::APP_BIN) != std::string_view::npos;
         }
 
         std::string MakeError(std::string_view code, std::string_view message) {
@@ -215,54 +128,32 @@ namespace http_handler {
             return json::serialize(error);
         }
 
-        template<typename... Verbs>
-        std::optional<RawResponse> ValidateHttpMethod(const StringRequest& req, Verbs&&... allowed_verbs) {
+        const RawResponse& UnknownTokenError() {
+            static const RawResponse not_found_player = {http::status::unauthorized, MakeError("unknownToken"sv, "Player token has not been found"sv)};
+            return not_found_player;
+        }
+
+        // Ставит ETag и заменяет ответ на 304 без тела, если клиент прислал совпадающий If-None-Match
+        void ApplyETag(const StringRequest& req, SharedResponse& response, std::string_view etag) {
+            auto if_none_match = req.find(http::field::if_none_match);
+            if (if_none_match != req.end() && MatchesETag(if_none_match->value(), etag)) {
+                // Тело не отправляется, Content-Length у 304 описывал бы полный ответ
+                static const auto empty_body = std::make_shared<const std::string>();
+                response.result(http::status::not_modified);
+                response.erase(http::field::content_length);
+                response.body() = empty_body;
+            }
+            response.set(http::field::etag, etag);
+        }
+
+        const RawResponse& InvalidMethodError() {
             static const RawResponse error {
                 http::status::method_not_allowed,
                 detail::MakeError("invalidMethod"sv, "Invalid method"sv)
             };
-
-            auto method = req.method();
-
-            if (((method == allowed_verbs) || ...)) {
-                //Метод поддерживается
-                return std::nullopt;
-            }
-            
             return error;
         }
 
-        std::unordered_map<std::string, std::string> ParseQueryParams(const StringRequest& req, std::string_view endpoint) {
-            std::string_view target = req.target();
-            if (!target.starts_with(endpoint)) {
-                throw std::invalid_argument("Invalid endpoint");
-            }
-
-            std::string_view query = target.substr(endpoint.size());
-            std::unordered_map<std::string, std::string> params;
-
-            if(query.empty() || query[0] != '?') {
-                return params;
-            }
-
-            // Убираем '?'
-            query.remove_prefix(1);
-
-            std::istringstream iss{std::string{query}};
-            std::string pair;
-
-            while (std::getline(iss, pair, '&')) {
-                size_t equal_pos = pair.find('=');
-                if(equal_pos != std::string::npos) {
-                    std::string key = pair.substr(0, equal_pos);
-                    std::string value = pair.substr(equal_pos + 1);
-                    params[key] = value;
-                }
-            }
-
-            return params;
-        }
-
     } //namespace detail
 
     StringResponse ApiHandler::MakeResponse(http::status status, std::string_view body, std::string_view allowed_method, unsigned http_version, bool keep_alive, std::string_view content_type) {
@@ -278,100 +169,186 @@ namespace http_handler {
         return response;
     }
 
-    std::optional<RawResponse> ApiHandler::AuthorizationPlayer(const StringRequest& req, app::Player** player) {
+    model::GameSession* ApiHandler::FindJoinSession(const StringRequest& req) const {
+        // Ошибки разбора вернёт HandleJoinGame, здесь только выбираем сессию
+        try {
+            json::value body = json::parse(req.body());
+            auto map_id = model::Map::Id{std::string(body.as_object().at("mapId").as_string())};
+            if (game_.FindMap(map_id) == nullptr) {
+                return nullptr;
+            }
+            return &game_.GetSession(map_id);
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+    }
+
+    SharedResponse ApiHandler::MakeSharedResponse(http::status status, std::shared_ptr<const std::string> body, std::string_view allowed_method, unsigned http_version, bool keep_alive, std::string_view content_type) {
+        SharedResponse response(status, http_version);
+        response.set(http::field::content_type, content_type);
+        response.content_length(body->size());
+        response.body() = std::move(body);
+        response.keep_alive(keep_alive);
+        response.set(http::field::cache_control, "no-cache"sv);
+        if (status == http::status::method_not_allowed) {
+            response.set(http::field::allow, allowed_method);
+        }
+        return response;
+    }
+
+    // Токен разбирается прямо из значения заголовка, без копирования в строку
+    std::optional<RawResponse> ApiHandler::ExtractToken(const StringRequest& req, app::TokenKey& token) {
         constexpr static std::string_view bearer_prefix = "Bearer ";
 
         static const RawResponse not_found_header = {http::status::unauthorized, detail::MakeError("invalidToken"sv, "Authorization header is required"sv)};
         static const RawResponse invalid_header_format = {http::status::unauthorized, detail::MakeError("invalidToken"sv, "Invalid authorization header format"sv)};
         static const RawResponse invalid_token = {http::status::unauthorized, detail::MakeError("invalidToken"sv, "Invalid token"sv)};
-        static const RawResponse not_found_player = {http::status::unauthorized, detail::MakeError("unknownToken"sv, "Player token has not been found"sv)};
 
-        if(player == nullptr) {
-            throw std::invalid_argument("Uninitialized argument");
-        }
-        
         auto auth_header = req.find(http::field::authorization);
         if (auth_header == req.end()) {
             return not_found_header;
         }
 
-        std::string auth_value = std::string(auth_header->value());
-        if (auth_value.size() < bearer_prefix.size() || auth_value.substr(0, bearer_prefix.size()) != bearer_prefix) {
+        std::string_view auth_value = auth_header->value();
+        if (!auth_value.starts_with(bearer_prefix)) {
             return invalid_header_format;
         }
         
-        std::string token = auth_value.substr(bearer_prefix.size());
-        if (token.empty() || token.size() != 32) {
+        auto hex = auth_value.substr(bearer_prefix.size());
+        if (hex.size() != app::TokenKey::HEX_SIZE) {
             return invalid_token;
         }
 
-        *player = app_.FindPlayerByToken(token);
-        if (*player == nullptr) {
-            return not_found_player;
+        // Токен правильной длины, но не из шестнадцатеричных цифр, выдан быть не мог
+        auto key = app::TokenKey::Parse(hex);
+        if (!key.has_value()) {
+            return detail::UnknownTokenError();
         }
 
+        token = *key;
         return std::nullopt;
     }
 
-    StringResponse ApiHandler::HandleAPIRequest(StringRequest&& req) {
-        const auto json_response = [&req](http::status status, std::string_view text, std::string_view allowed_method) {
-            return MakeResponse(status, text, allowed_method, req.version(), req.keep_alive());
+    StringResponse ApiHandler::HandleAPIRequest(StringRequest&& req, const RouteInfo& route) {
+        const auto json_response = [&req, &route](http::status status, std::string_view text) {
+            return MakeResponse(status, text, route.allow, req.version(), req.keep_alive());
+        };
+        // Ошибки всегда отдаются в JSON, бинарным бывает только успешный ответ
+        const auto negotiated_response = [&req, &route](http::status status, std::string_view text) {
+            auto content_type = status == http::status::ok && detail::AcceptsBinary(req) ? ContentType::APP_BIN : ContentType::APP_JSON;
+            return MakeResponse(status, text, route.allow, req.version(), req.keep_alive(), content_type);
         };
 
-        auto target = req.target();
-
-        if (target == Endpoints::JOIN_GAME) {
-            auto [status, str] = HandleJoinGame(req);           
-            return json_response(status, str, AllowedMethod::POST);
+        if (route.route == Route::UNKNOWN) {
+            auto [status, str] = HandleUnknownTarget(req);
+            return json_response(status, str);
         }
 
-        if (target == Endpoints::PLAYERS) {
-            auto [status, str] = HandleGetPlayers(req);
-            return json_response(status, str, AllowedMethod::GET_HEAD);
+        // При автоматическом тике адреса /tick нет, метод для него не проверяется
+        if (route.route == Route::TICK && tick_period_.has_value()) {
+            return json_response(http::status::bad_request, detail::MakeError("badRequest"sv, "Invalid endpoint"sv));
         }
 
-        if (target == Endpoints::STATE) {
-            auto [status, str] = HandleState(req);
-            return json_response(status, str, AllowedMethod::GET_HEAD);
+        if (!route.Allows(req.method())) {
+            const auto& [status, str] = detail::InvalidMethodError();
+            return json_response(status, str);
         }
 
-        if (target == Endpoints::PLAYER_ACTION) {
+        switch (route.route) {
+        case Route::JOIN_GAME: {
+            auto [status, str] = HandleJoinGame(req);
+            return json_response(status, str);
+        }
+        case Route::PLAYERS: {
+            auto [status, str] = HandleGetPlayers(req);
+            return negotiated_response(status, str);
+        }
+        case Route::PLAYER_ACTION: {
             auto [status, str] = HandlePlayerAction(req);
-            return json_response(status, str, AllowedMethod::POST);
+            return json_response(status, str);
         }
-
-        if (target == Endpoints::TICK) {
+        case Route::TICK: {
             auto [status, str] = HandleTick(req);
-            return json_response(status, str, AllowedMethod::POST);
+            return json_response(status, str);
         }
-
-        if (target.starts_with(Endpoints::RECORDS)) {
+        case Route::RECORDS: {
             auto [status, str] = HandleRecords(req);
-            return json_response(status, str, AllowedMethod::GET_HEAD);
+            return json_response(status, str);
+        }
+        case Route::SOCKET: {
+            auto [status, str] = HandleSocket(req);
+            return json_response(status, str);
+        }
+        default: {
+            // STATE и карты обрабатываются в operator()
+            auto [status, str] = HandleUnknownTarget(req);
+            return json_response(status, str);
+        }
+        }
+    }
+
+    // Сюда доходят только запросы, которые GameSocketHandler не принял
+    RawResponse ApiHandler::HandleSocket(const StringRequest& req) const {
+        if (!websocket::is_upgrade(req)) {
+            return {http::status::upgrade_required, detail::MakeError("upgradeRequired"sv, "WebSocket upgrade is required"sv)};
         }
 
-        auto [status, str] = HandleGetMaps(req);
-        return json_response(status, str, AllowedMethod::GET_HEAD);
+        return {http::status::unauthorized, detail::MakeError("invalidToken"sv, "Invalid token"sv)};
     }
 
-    RawResponse ApiHandler::HandleGetMaps(const StringRequest& req) const{
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::get, http::verb::head)) {
-            return *error;
+    void ApiHandler::BuildMapsCache() {
+        const auto make_cached = [](std::string body) {
+            auto etag = MakeETag(body);
+            return CachedBody{
+                .body = std::make_shared<const std::string>(std::move(body)),
+                .etag = std::move(etag)
+            };
+        };
+
+        maps_list_ = make_cached(detail::GetMaps(game_));
+        for (const auto& map : game_.GetMaps()) {
+            maps_.emplace(*map->GetId(), CachedMap{
+                .json = make_cached(json::serialize(detail::serialize::SerializeMap(map, extra_data_))),
+                .binary = make_cached(binary_encoding::EncodeMap(*map, extra_data_))
+            });
         }
+    }
 
-        auto target = req.target();
+    SharedResponse ApiHandler::HandleMapsRequest(const StringRequest& req, const RouteMatch& match) const {
+        const bool map_by_id = match.GetRoute() == Route::MAP_BY_ID;
+        const bool binary = map_by_id && detail::AcceptsBinary(req);
 
-        if(target == Endpoints::MAPS) {
-            auto maps = detail::GetMaps(target, game_);
-            return {http::status::ok, maps};
+        const CachedBody* cached = nullptr;
+        if (!map_by_id) {
+            cached = &maps_list_;
+        } else if (auto it = maps_.find(match.path.substr(Endpoints::MAP_BY_ID.size())); it != maps_.end()) {
+            cached = binary ? &it->second.binary : &it->second.json;
         }
 
-        if(target.starts_with(Endpoints::MAP_BY_ID)  && target.size() > Endpoints::MAP_BY_ID.size()){
-            auto map = detail::GetMap(target, game_, extra_data_);
-            if (map.has_value()) {
-                return {http::status::ok, map.value()};
-            }
+        if (cached == nullptr || !match.info->Allows(req.method())) {
+            auto [status, body] = HandleUnknownTarget(req);
+            return MakeSharedResponse(status, std::make_shared<const std::string>(std::move(body)), AllowedMethod::GET_HEAD, req.version(), req.keep_alive());
+        }
+
+        const auto content_type = binary ? ContentType::APP_BIN : ContentType::APP_JSON;
+        SharedResponse response = MakeSharedResponse(http::status::ok, cached->body, AllowedMethod::GET_HEAD, req.version(), req.keep_alive(), content_type);
+        detail::ApplyETag(req, response, cached->etag);
+        if (map_by_id) {
+            response.set(http::field::vary, "Accept"sv);
+        }
+
+        return response;
+    }
+
+    // Ошибки для неизвестных адресов и ненайденных карт
+    RawResponse ApiHandler::HandleUnknownTarget(const StringRequest& req) const{
+        if (!routes::UNKNOWN_ROUTE.Allows(req.method())) {
+            return detail::InvalidMethodError();
+        }
+
+        auto target = req.target();
 
+        if(target.starts_with(Endpoints::MAP_BY_ID)  && target.size() > Endpoints::MAP_BY_ID.size()){
             return {http::status::not_found, detail::MakeError("mapNotFound"sv, "Map not found"sv)};
         }
 
@@ -383,16 +360,19 @@ namespace http_handler {
     }
     
     RawResponse ApiHandler::HandleJoinGame(const StringRequest& req){
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::post)) {
-            return *error;
-        }
+        // Имя попадает в таблицу рекордов, колонка name там - varchar(100)
+        constexpr static size_t max_user_name_length = 100;
 
         try {
             json::value body = json::parse(req.body());
             const json::object& obj = body.as_object();
 
             std::string userName = std::string(obj.at("userName").as_string());
-            if (userName.empty()) {
+            // varchar считает символы, а не байты: продолжения UTF-8 (10xxxxxx) не учитываются
+            const auto name_length = std::count_if(userName.begin(), userName.end(), [](char c) {
+                return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            });
+            if (userName.empty() || static_cast<size_t>(name_length) > max_user_name_length) {
                 return {http::status::bad_request, detail::MakeError("invalidArgument"sv, "Invalid userName"sv)};
             }
 
@@ -406,6 +386,8 @@ namespace http_handler {
             auto& session = game_.GetSession(model::Map::Id{mapId});
             auto& dog = session.AddDog(userName);
             auto [token, player_id] = app_.AddPlayer(session, dog);
+            // Снимок публикуется после добавления игрока, чтобы у каждой собаки снимка уже был игрок
+            session.PublishSnapshot();
 
             json::object answer {
                 {"authToken", token},
@@ -420,70 +402,127 @@ namespace http_handler {
     }
     
 
-    RawResponse ApiHandler::HandleGetPlayers(const StringRequest& req){
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::get, http::verb::head)) {
-            return *error;
+    std::optional<RawResponse> ApiHandler::AuthorizationSession(const StringRequest& req, app::Application::SessionView& view) {
+        app::TokenKey token;
+        if (auto error = ExtractToken(req, token)) {
+            return error;
         }
 
-        app::Player* player = nullptr;
-        if(auto error = AuthorizationPlayer(req, &player)) {
+        auto found = app_.FindSessionViewByToken(token);
+        if (!found.has_value()) {
+            return detail::UnknownTokenError();
+        }
+
+        view = std::move(*found);
+        return std::nullopt;
+    }
+
+    RawResponse ApiHandler::HandleGetPlayers(const StringRequest& req){
+        app::Application::SessionView view;
+        if(auto error = AuthorizationSession(req, view)) {
             return *error;
         }
 
-        const auto* session = player->GetSession();
-        auto players = app_.GetPlayersInSession(session);
+        if (detail::AcceptsBinary(req)) {
+            return {http::status::ok, binary_encoding::EncodePlayers(*view.players)};
+        }
 
         json::object players_json;
-        for (auto* p : players) {
-            std::string id = std::to_string(p->GetId());
+        for (const auto& p : *view.players) {
+            std::string id = std::to_string(p.id);
 
             json::object player_info;
-            player_info["name"] = p->GetName();
+            player_info["name"] = p.name;
             players_json[id] = player_info;
         }
 
         return {http::status::ok, json::serialize(players_json)};
     }
 
-    RawResponse ApiHandler::HandleState(const StringRequest& req) {
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::get, http::verb::head)) {
-            return *error;
+    SharedResponse ApiHandler::HandleStateRequest(const StringRequest& req, const RouteMatch& match) {
+        const bool binary = detail::AcceptsBinary(req);
+        std::string etag;
+        auto [status, body] = HandleState(req, match, binary, etag);
+        auto content_type = status == http::status::ok && binary ? ContentType::APP_BIN : ContentType::APP_JSON;
+        auto response = MakeSharedResponse(status, std::move(body), AllowedMethod::GET_HEAD, req.version(), req.keep_alive(), content_type);
+        if (!etag.empty()) {
+            detail::ApplyETag(req, response, etag);
+            // Ответ зависит от формата и от сессии, в которую ведёт токен
+            response.set(http::field::vary, "Accept, Authorization"sv);
         }
+        return response;
+    }
 
-        app::Player* player = nullptr;
-        if(auto error = AuthorizationPlayer(req, &player)) {
-            return *error;
+    SharedRawResponse ApiHandler::HandleState(const StringRequest& req, const RouteMatch& match, bool binary, std::string& etag) {
+        const auto to_shared = [](RawResponse error) -> SharedRawResponse {
+            return {error.first, std::make_shared<const std::string>(std::move(error.second))};
+        };
+
+        if (!match.info->Allows(req.method())) {
+            return to_shared(detail::InvalidMethodError());
         }
 
-        const auto* session = player->GetSession();
-        auto players = app_.GetPlayersInSession(session);
+        app::Application::SessionView view;
+        if(auto error = AuthorizationSession(req, view)) {
+            return to_shared(*error);
+        }
 
-        const auto& loot_in_map = session->GetLootInMap();
-        auto lost_object = detail::serialize::SerializeLootsMap(loot_in_map);
+        auto since_param = QueryString{match.query}.Find("since"sv);
+        if (!since_param.has_value()) {
+            // ETag есть только у полного состояния: дельта зависит от since
+            auto state = GetStateBody(view, binary);
+            etag = state->etag;
+            return {http::status::ok, state->body};
+        }
 
-        json::object state_json {
-            {"players", json::object{}},
-            {"lostObjects", std::move(lost_object)}
-        };
+        // ?since=<tick> - только изменения после указанной версии состояния
+        auto since = QueryString::ParseNumber<uint64_t>(*since_param);
+        if (!since.has_value()) {
+            return to_shared({http::status::bad_request, detail::MakeError("invalidArgument"sv, "Invalid since parameter"sv)});
+        }
+
+        auto body = binary ? binary_encoding::EncodeStateDelta(view, *since) : state_json::MakeStateDelta(view, *since);
+        return {http::status::ok, std::make_shared<const std::string>(std::move(body))};
+    }
 
-        auto& players_json = state_json["players"].as_object();
+    std::shared_ptr<const ApiHandler::StateCache> ApiHandler::GetStateBody(const app::Application::SessionView& view, bool binary) {
+        // Читаем опубликованный после тика снимок, strand сессии не нужен
+        const auto& snapshot = view.snapshot;
 
-        for (auto* p : players) {
-            std::string id = std::to_string(p->GetId());
-            players_json[id] = detail::serialize::SerializeDog(&p->GetDog());
+        auto& cache_slot = state_cache_.at(view.session)[binary ? 1 : 0];
+        auto cache = std::atomic_load(&cache_slot);
+        // Состояние одинаково для всех игроков сессии: пока не было тика и
+        // список игроков не менялся, отдаём уже сериализованную строку
+        if (cache && cache->version == snapshot->version && cache->players == view.players) {
+            return cache;
         }
 
-        return {http::status::ok, json::serialize(state_json)};
+        auto body = std::make_shared<const std::string>(binary ? binary_encoding::EncodeState(view) : state_json::MakeState(view));
+        auto etag = MakeETag(*body);
+
+        // При одновременном промахе несколько потоков посчитают одно и то же,
+        // в кэше останется любой из результатов
+        cache = std::make_shared<const StateCache>(StateCache{
+            .version = snapshot->version,
+            .players = view.players,
+            .body = std::move(body),
+            .etag = std::move(etag)
+        });
+        std::atomic_store(&cache_slot, cache);
+
+        return cache;
     }
     
     RawResponse ApiHandler::HandlePlayerAction(const StringRequest& req) {
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::post)) {
+        // Обработчик работает вне strand сессии: команда только ставится в очередь
+        // и применяется в начале следующего тика
+        app::TokenKey token;
+        if(auto error = ExtractToken(req, token)) {
             return *error;
         }
 
-        app::Player* player = nullptr;
-        if(auto error = AuthorizationPlayer(req, &player)) {
-            return *error;
+        if (app_.FindSessionByToken(token) == nullptr) {
+            return detail::UnknownTokenError();
         }
 
         auto content_header = req.find(http::field::content_type);
@@ -510,8 +549,10 @@ namespace http_handler {
                 throw std::invalid_argument("Invalid Direction");
             }
 
-            auto& dog = player->GetDog();
-            dog.Action(dir);
+            // Игрок мог покинуть игру после проверки токена
+            if (!app_.PushPlayerAction(token, dir)) {
+                return detail::UnknownTokenError();
+            }
         } catch (const std::exception& ex) {
             std::string error = "Failed to parse action: "s + std::string(ex.what());
             return {http::status::bad_request, detail::MakeError("invalidArgument"sv, error)};
@@ -521,14 +562,6 @@ namespace http_handler {
     }
 
     RawResponse ApiHandler::HandleTick(const StringRequest& req) {
-        if (tick_period_.has_value()) {
-            return {http::status::bad_request, detail::MakeError("badRequest"sv, "Invalid endpoint"sv)};
-        }
-        
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::post)) {
-            return *error;
-        }
-        
         try {
             auto body = json::parse(req.body());
             const auto& obj = body.as_object();
@@ -559,35 +592,49 @@ namespace http_handler {
     }
 
     RawResponse ApiHandler::HandleRecords(const StringRequest& req) const {
-        if(auto error = detail::ValidateHttpMethod(req, http::verb::get, http::verb::head)) {
-            return *error;
-        }
-
         try {
-            auto params = detail::ParseQueryParams(req, Endpoints::RECORDS);
-            int64_t max_items = 100;
-            int64_t start = 0;
-            
-            if (auto it = params.find("maxItems"); it != params.end()) {
-                max_items = std::stoi(it->second);
-            }
+            const QueryString params{routes::QueryOf(req.target())};
+            // Хранилище принимает int: значения вне [0, INT_MAX] - ошибка запроса, а не переполнение
+            const auto parse_param = [&params](std::string_view key, int default_value) {
+                auto value = params.Find(key);
+                if (!value.has_value()) {
+                    return default_value;
+                }
+                auto number = QueryString::ParseNumber<int>(*value);
+                if (!number.has_value() || *number < 0) {
+                    throw std::invalid_argument("Invalid value of "s + std::string(key));
+                }
+                return *number;
+            };
 
+            int max_items = parse_param("maxItems"sv, 100);
             if (max_items > 100) {
                 throw std::invalid_argument("Value max_items > 100");
             }
 
-            if (auto it = params.find("start"); it != params.end()) {
-                start = std::stoi(it->second);
+            // Курсор after ищется по индексу, start пропускает строки и замедляется с глубиной
+            std::vector<DTO::Score> scores;
+            if (auto after = params.Find("after"sv)) {
+                if (params.Find("start"sv).has_value()) {
+                    throw std::invalid_argument("start and after can't be used together");
+                }
+                auto cursor = records_cursor::Decode(*after);
+                if (!cursor.has_value()) {
+                    throw std::invalid_argument("Invalid value of after");
+                }
+                scores = app_.GetScoresAfter(*cursor, max_items);
+            } else {
+                scores = app_.GetScores(max_items, parse_param("start"sv, 0));
             }
 
-            auto scores = app_.GetScores(max_items, start);
             json::array score_json;
             for (const auto& score : scores) {
                 score_json.push_back(
                     json::object{
                         {"name", score.name},
                         {"score", score.score},
-                        {"playTime", static_cast<double>(score.play_time_ms / 1000.0)}
+                        {"playTime", static_cast<double>(score.play_time_ms / 1000.0)},
+                        {"cursor", records_cursor::Encode(score)}
                     }
                 );
             }
@@ -2,17 +2,25 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/bind_executor.hpp>
+#include <boost/beast/websocket/rfc6455.hpp>
+#include <array>
+#include <map>
 #include <optional>
+#include <memory>
+#include <unordered_map>
 
 #include "model.h"
 #include "application.h"
 #include "common_type.h"
 #include "extra_data.h"
+#include "route_table.h"
 
 namespace http_handler {
     namespace net = boost::asio;
+    namespace websocket = beast::websocket;
     
     using RawResponse = std::pair<http::status, std::string>;
+    using SharedRawResponse = std::pair<http::status, std::shared_ptr<const std::string>>;
 
     class ApiHandler {
     public:
@@ -24,13 +32,46 @@ namespace http_handler {
             , extra_data_{extra_data}
             , strand_{api_strand}
             , tick_period_{tick_period} {
+            // Набор сессий не меняется после загрузки, поэтому ключи кэша заводятся заранее,
+            // а дальше атомарно заменяются только значения
+            for (const auto& [map_id, session] : game_.GetSessions()) {
+                state_cache_.emplace(&session, StateCacheSlots{});
+            }
+            BuildMapsCache();
         }
+        /*
+         * Вход в игру выполняется в strand сессии, /tick — в strand_.
+         * Остальные запросы не трогают живое состояние сессий: чтение идёт
+         * из опубликованных снимков, действия ставятся в очередь сессии,
+         * поэтому они обрабатываются сразу в потоке ввода-вывода
+         */
         template <typename Body, typename Allocator, typename Send>
         void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send){
-            net::dispatch(strand_, [self = this, req = std::move(req), send = std::forward<Send>(send)]() mutable {
-                StringResponse response = self->HandleAPIRequest(std::move(req));
-                send(std::move(response));
-            });
+            // Маршрут и допустимые методы определяются одним поиском в таблице route_table.h
+            const auto match = routes::Match(req.target());
+
+            switch (match.GetRoute()) {
+            case Route::STATE:
+                send(HandleStateRequest(req, match));
+                return;
+            case Route::MAPS:
+            case Route::MAP_BY_ID:
+                send(HandleMapsRequest(req, match));
+                return;
+            case Route::TICK:
+                Dispatch(strand_, *match.info, std::move(req), std::forward<Send>(send));
+                return;
+            case Route::JOIN_GAME:
+                if (auto* session = FindJoinSession(req)) {
+                    Dispatch(session->GetStrand(), *match.info, std::move(req), std::forward<Send>(send));
+                    return;
+                }
+                break;
+            default:
+                break;
+            }
+
+            send(HandleAPIRequest(std::move(req), *match.info));
         }
     private:
         model::Game& game_;
@@ -38,16 +79,58 @@ namespace http_handler {
         extra_data::ExtraData& extra_data_;
         Strand strand_;
         std::optional<int64_t> tick_period_;
+
+        // Сериализованное состояние сессии, общее для всех игроков до следующего тика
+        struct StateCache {
+            uint64_t version = 0;
+            std::shared_ptr<const app::Application::SessionPlayers> players;
+            std::shared_ptr<const std::string> body;
+            // Считается один раз вместе с телом, меняется с версией снимка
+            std::string etag;
+        };
+        // Отдельные ячейки для JSON и бинарного представления.
+        // Значения читаются и заменяются через std::atomic_load/atomic_store
+        using StateCacheSlots = std::array<std::shared_ptr<const StateCache>, 2>;
+        std::unordered_map<const model::GameSession*, StateCacheSlots> state_cache_;
+
+        // Карты не меняются после загрузки, поэтому ответы /maps и /maps/{id}
+        // сериализуются один раз в конструкторе и отдаются с ETag
+        struct CachedBody {
+            std::shared_ptr<const std::string> body;
+            std::string etag;
+        };
+        struct CachedMap {
+            CachedBody json;
+            CachedBody binary;
+        };
+        CachedBody maps_list_;
+        std::map<std::string, CachedMap, std::less<>> maps_;
     private:
+        // Описание маршрута лежит в статической таблице, поэтому его можно передать по ссылке
+        template <typename Executor, typename Request, typename Send>
+        void Dispatch(Executor& executor, const RouteInfo& route, Request&& req, Send&& send) {
+            net::dispatch(executor, [self = this, &route, req = std::forward<Request>(req), send = std::forward<Send>(send)]() mutable {
+                StringResponse response = self->HandleAPIRequest(std::move(req), route);
+                send(std::move(response));
+            });
+        }
+
+        model::GameSession* FindJoinSession(const StringRequest& req) const;
+
         RawResponse HandleJoinGame(const StringRequest& req);
         RawResponse HandleGetPlayers(const StringRequest& req);
-        RawResponse HandleState(const StringRequest& req);
+        SharedRawResponse HandleState(const StringRequest& req, const RouteMatch& match, bool binary, std::string& etag);
+        SharedResponse HandleStateRequest(const StringRequest& req, const RouteMatch& match);
+        std::shared_ptr<const StateCache> GetStateBody(const app::Application::SessionView& view, bool binary);
         RawResponse HandlePlayerAction(const StringRequest& req);
-        RawResponse HandleGetMaps(const StringRequest& req) const;
+        void BuildMapsCache();
+        SharedResponse HandleMapsRequest(const StringRequest& req, const RouteMatch& match) const;
+        RawResponse HandleUnknownTarget(const StringRequest& req) const;
         RawResponse HandleTick(const StringRequest& req);
         RawResponse HandleRecords(const StringRequest& req) const;
+        RawResponse HandleSocket(const StringRequest& req) const;
 
-        StringResponse HandleAPIRequest(StringRequest&& req);
+        StringResponse HandleAPIRequest(StringRequest&& req, const RouteInfo& route);
         static StringResponse MakeResponse(
             http::status status, 
             std::string_view body, 
@@ -57,6 +140,16 @@ namespace http_handler {
             std::string_view content_type = ContentType::APP_JSON
         );
 
-        std::optional<RawResponse> AuthorizationPlayer(const StringRequest& req, app::Player** player);
+        static SharedResponse MakeSharedResponse(
+            http::status status,
+            std::shared_ptr<const std::string> body,
+            std::string_view allowed_method,
+            unsigned http_version,
+            bool keep_alive,
+            std::string_view content_type = ContentType::APP_JSON
+        );
+
+        static std::optional<RawResponse> ExtractToken(const StringRequest& req, app::TokenKey& token);
+        std::optional<RawResponse> AuthorizationSession(const StringRequest& req, app::Application::SessionView& view);
     };
 } //namespace http_handler
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "binary_encoding.h"
+#include "binary_writer.h"
+#include "state_delta.h"
+
+#include <boost/json.hpp>
+
+
+namespace json = boost::json;
+
+namespace http_handler::binary_encoding {
+    namespace {
+        void WriteKind(binary::Writer& writer, MessageKind kind) {
+            writer.WriteByte(static_cast<uint8_t>(kind));
+        }
+
+        void WriteDog(binary::Writer& writer, const model::DogSnapshot& dog) {
+            writer.WriteQuantized(dog.pos.x);
+            writer.WriteQuantized(dog.pos.y);
+            writer.WriteQuantized(dog.speed.h_speed);
+            writer.WriteQuantized(dog.speed.v_speed);
+            // Порядок Direction совпадает с кодами U, D, L, R
+            writer.WriteByte(static_cast<uint8_t>(dog.dir));
+            writer.WriteVarint(static_cast<uint64_t>(dog.score));
+
+            writer.WriteVarint(dog.bag.size());
+            for (const auto& loot : dog.bag) {
+                writer.WriteVarint(static_cast<uint64_t>(loot.id));
+                writer.WriteVarint(loot.type);
+            }
+        }
+
+        void WriteLoot(binary::Writer& writer, const model::Loot& loot) {
+            writer.WriteVarint(static_cast<uint64_t>(loot.id));
+            writer.WriteVarint(loot.type);
+            writer.WriteQuantized(loot.pos.x);
+            writer.WriteQuantized(loot.pos.y);
+        }
+
+        void WritePoint(binary::Writer& writer, model::Point point) {
+            writer.WriteSigned(point.x);
+            writer.WriteSigned(point.y);
+        }
+    } //namespace
+
+    std::string EncodeState(const app::Application::SessionView& view) {
+        const auto& snapshot = *view.snapshot;
+        binary::Writer writer;
+        WriteKind(writer, MessageKind::STATE);
+        writer.WriteVarint(snapshot.version);
+
+        // Игроки без собаки в снимке пропускаются, число пишем после подсчёта
+        std::vector<std::pair<app::Player::Id, const model::DogSnapshot*>> players;
+        players.reserve(view.players->size());
+        for (const auto& p : *view.players) {
+            if (const auto* dog = snapshot.FindDog(p.dog_id)) {
+                players.emplace_back(p.id, dog);
+            }
+        }
+
+        writer.WriteVarint(players.size());
+        for (const auto& [id, dog] : players) {
+            writer.WriteVarint(id);
+            WriteDog(writer, *dog);
+        }
+
+        writer.WriteVarint(snapshot.loot_in_map.size());
+        for (const auto& loot : snapshot.loot_in_map) {
+            WriteLoot(writer, loot);
+        }
+
+        return writer.Release();
+    }
+
+    std::string EncodeStateDelta(const app::Application::SessionView& view, uint64_t since) {
+        auto delta = CollectStateDelta(view, since);
+        if (!delta) {
+            return EncodeState(view);
+        }
+
+        binary::Writer writer;
+        WriteKind(writer, MessageKind::STATE_DELTA);
+        writer.WriteVarint(view.snapshot->version);
+
+        writer.WriteVarint(delta->players.size());
+        for (const auto& player : delta->players) {
+            writer.WriteVarint(player.id);
+            WriteDog(writer, *player.dog);
+        }
+
+        writer.WriteVarint(delta->removed_players.size());
+        for (auto id : delta->removed_players) {
+            writer.WriteVarint(id);
+        }
+
+        writer.WriteVarint(delta->loot.size());
+        for (const auto* loot : delta->loot) {
+            WriteLoot(writer, *loot);
+        }
+
+        writer.WriteVarint(delta->removed_loot.size());
+        for (auto id : delta->removed_loot) {
+            writer.WriteVarint(static_cast<uint64_t>(id));
+        }
+
+        return writer.Release();
+    }
+
+    std::string EncodePlayers(const app::Application::SessionPlayers& players) {
+        binary::Writer writer;
+        WriteKind(writer, MessageKind::PLAYERS);
+
+        writer.WriteVarint(players.size());
+        for (const auto& p : players) {
+            writer.WriteVarint(p.id);
+            writer.WriteString(p.name);
+        }
+
+        return writer.Release();
+    }
+
+    std::string EncodeMap(const model::Map& map, const extra_data::ExtraData& extra_data) {
+        binary::Writer writer;
+        WriteKind(writer, MessageKind::MAP);
+        writer.WriteString(*map.GetId());
+        writer.WriteString(map.GetName());
+
+        // Типы лута сервер не интерпретирует, они передаются клиенту как есть
+        auto loot_types = extra_data.GetLootTypes(map.GetId());
+        writer.WriteString(json::serialize(loot_types.has_value() ? *loot_types : json::array{}));
+
+        const auto& roads = map.GetRoads();
+        writer.WriteVarint(roads.size());
+        for (const auto& road : roads) {
+            writer.WriteByte(road.IsVertical() ? 1 : 0);
+            WritePoint(writer, road.GetStart());
+            writer.WriteSigned(road.IsVertical() ? road.GetEnd().y : road.GetEnd().x);
+        }
+
+        const auto& buildings = map.GetBuildings();
+        writer.WriteVarint(buildings.size());
+        for (const auto& building : buildings) {
+            const auto& bounds = building.GetBounds();
+            WritePoint(writer, bounds.position);
+            writer.WriteSigned(bounds.size.width);
+            writer.WriteSigned(bounds.size.height);
+        }
+
+        const auto& offices = map.GetOffices();
+        writer.WriteVarint(offices.size());
+        for (const auto& office : offices) {
+            writer.WriteString(*office.GetId());
+            WritePoint(writer, office.GetPosition());
+            writer.WriteSigned(office.GetOffset().dx);
+            writer.WriteSigned(office.GetOffset().dy);
+        }
+
+        return writer.Release();
+    }
+} //namespace http_handler::binary_encoding
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "model.h"
+#include "application.h"
+#include "extra_data.h"
+
+/*
+ * Бинарное представление ответов API для нативных клиентов и ботов
+ * (Accept: application/octet-stream). Примитивы описаны в binary_writer.h.
+ * Первый байт сообщения - его тип (MessageKind).
+ *
+ * Собака:  x, y, vx, vy (квантованные), dir (байт: 0-U, 1-D, 2-L, 3-R),
+ *          score, число предметов в рюкзаке, для каждого id и type
+ * Лут:     id, type, x, y (квантованные)
+ *
+ * STATE:       tick, число игроков, для каждого id и собака, число лута, лут
+ * STATE_DELTA: tick, изменившиеся игроки (как в STATE), число и id ушедших
+ *              игроков, новый лут, число и id подобранного лута
+ * PLAYERS:     число игроков, для каждого id и имя (строка)
+ * MAP:         id, name, lootTypes (JSON-строка), дороги (байт 0 - горизонтальная,
+ *              1 - вертикальная, x0, y0, x1 или y1), здания (x, y, w, h),
+ *              офисы (id, x, y, offsetX, offsetY). Перед каждым списком - его длина
+ */
+namespace http_handler::binary_encoding {
+    enum class MessageKind : uint8_t {
+        STATE = 1,
+        STATE_DELTA = 2,
+        PLAYERS = 3,
+        MAP = 4
+    };
+
+    // Полное состояние, лут адресуется по id
+    std::string EncodeState(const app::Application::SessionView& view);
+    // Изменения после версии since, либо STATE, если история уже потеряна
+    std::string EncodeStateDelta(const app::Application::SessionView& view, uint64_t since);
+    std::string EncodePlayers(const app::Application::SessionPlayers& players);
+    std::string EncodeMap(const model::Map& map, const extra_data::ExtraData& extra_data);
+} //namespace http_handler::binary_encoding
@@ -1,6 +1,8 @@
 #pragma once
 #include <string_view>
 #include <boost/beast/http.hpp>
+#include "shared_string_body.h"
+#include "file_range_body.h"
 
 
 namespace http_handler {
@@ -14,6 +16,10 @@ namespace http_handler {
     using StringResponse = http::response<http::string_body>;
     // Ответ, тело которого представлено в виде файла
     using FileResponse = http::response<http::file_body>;
+    // Ответ с диапазоном байт файла, отправляется через sendfile
+    using FileRangeResponse = http::response<http_server::FileRangeBody>;
+    // Ответ с разделяемым неизменяемым телом, отправляется без копирования
+    using SharedResponse = http::response<SharedStringBody>;
 
     struct ContentType {
         ContentType() = delete;
@@ -46,10 +52,12 @@ namespace http_handler {
         constexpr static std::string_view PLAYER_ACTION = "/api/v1/game/player/action"sv;
         constexpr static std::string_view TICK = "/api/v1/game/tick"sv;
         constexpr static std::string_view RECORDS = "/api/v1/game/records"sv;
+        constexpr static std::string_view SOCKET = "/api/v1/game/socket"sv;
     };
 
     struct AllowedMethod {
         AllowedMethod() = delete;
+        constexpr static std::string_view GET = "GET"sv;
         constexpr static std::string_view GET_HEAD = "GET, HEAD"sv;
         constexpr static std::string_view POST = "POST"sv;
     };
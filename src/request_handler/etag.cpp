@@ -0,0 +1,50 @@
+#include "etag.h"
+
+#include <cstdint>
+#include <cstdio>
+
+
+namespace http_handler {
+    using namespace std::literals;
+
+    std::string MakeETag(std::string_view body) {
+        constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+        constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+        uint64_t hash = FNV_OFFSET;
+        for (unsigned char c : body) {
+            hash ^= c;
+            hash *= FNV_PRIME;
+        }
+
+        char buffer[19];
+        std::snprintf(buffer, sizeof(buffer), "\"%016llx\"", static_cast<unsigned long long>(hash));
+        return std::string(buffer, 18);
+    }
+
+    bool MatchesETag(std::string_view if_none_match, std::string_view etag) {
+        constexpr auto weak_prefix = "W/"sv;
+
+        while (!if_none_match.empty()) {
+            auto comma = if_none_match.find(',');
+            auto tag = if_none_match.substr(0, comma);
+            if_none_match.remove_prefix(comma == std::string_view::npos ? if_none_match.size() : comma + 1);
+
+            while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) {
+                tag.remove_prefix(1);
+            }
+            while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) {
+                tag.remove_suffix(1);
+            }
+            if (tag.starts_with(weak_prefix)) {
+                tag.remove_prefix(weak_prefix.size());
+            }
+
+            if (tag == "*"sv || tag == etag) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+} //namespace http_handler
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace http_handler {
+    // Сильный ETag по содержимому: хеш FNV-1a в кавычках, например "1b2c3d4e5f607182"
+    std::string MakeETag(std::string_view body);
+
+    // Проверяет значение If-None-Match: список ETag через запятую или "*".
+    // Сравнение слабое (RFC 9110), поэтому W/"x" совпадает с "x"
+    bool MatchesETag(std::string_view if_none_match, std::string_view etag);
+} //namespace http_handler
@@ -0,0 +1,111 @@
+#include "game_socket_handler.h"
+#include "route_table.h"
+#include "query_string.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/json.hpp>
+
+
+namespace json = boost::json;
+
+namespace http_handler {
+    using namespace std::literals;
+    namespace {
+        http_server::WebSocketSession::Message MakeError(std::string_view code, std::string_view message) {
+            json::object error{
+                {"code", code},
+                {"message", message}
+            };
+            return std::make_shared<const std::string>(json::serialize(error));
+        }
+    } //namespace
+
+    GameSocketHandler::GameSocketHandler(model::Game& game, app::Application& app, Strand strand)
+        : app_{app}
+        , strand_{strand}
+        , broadcaster_{game, app} {
+    }
+
+    bool GameSocketHandler::operator()(const StringRequest& req, beast::tcp_stream& stream) {
+        if (routes::Match(req.target()).GetRoute() != Route::SOCKET) {
+            return false;
+        }
+
+        auto token = ExtractToken(req);
+        if (!token) {
+            return false;
+        }
+
+        auto view = app_.FindSessionViewByToken(*token);
+        if (!view) {
+            return false;
+        }
+
+        const auto* session = view->session;
+        auto socket = std::make_shared<http_server::WebSocketSession>(std::move(stream));
+        socket->Run(req,
+            [this, weak_socket = std::weak_ptr{socket}, token = *token](std::string_view message) {
+                if (auto socket = weak_socket.lock()) {
+                    HandleMessage(socket, token, message);
+                }
+            },
+            [this, session, raw_socket = socket.get()] {
+                broadcaster_.Unsubscribe(session, raw_socket);
+            });
+
+        broadcaster_.Subscribe(*view, socket, *token);
+        return true;
+    }
+
+    void GameSocketHandler::OnTick() {
+        net::post(strand_, [this] {
+            broadcaster_.Broadcast();
+        });
+    }
+
+    // Браузерный WebSocket не умеет задавать заголовки, поэтому токен можно передать и в ?token=
+    std::optional<app::TokenKey> GameSocketHandler::ExtractToken(const StringRequest& req) {
+        constexpr static std::string_view bearer_prefix = "Bearer "sv;
+
+        std::string_view token;
+        if (auto auth_header = req.find(http::field::authorization); auth_header != req.end()) {
+            std::string_view auth_value = auth_header->value();
+            if (auth_value.starts_with(bearer_prefix)) {
+                token = auth_value.substr(bearer_prefix.size());
+            }
+        } else if (auto param = QueryString{routes::QueryOf(req.target())}.Find("token"sv)) {
+            token = *param;
+        }
+
+        return app::TokenKey::Parse(token);
+    }
+
+    void GameSocketHandler::HandleMessage(const std::shared_ptr<http_server::WebSocketSession>& socket, app::TokenKey token, std::string_view message) {
+        try {
+            auto body = json::parse(message);
+            const auto& obj = body.as_object();
+
+            auto it = obj.find("move");
+            if (it == obj.end()) {
+                throw std::invalid_argument("Missing \"move\" field");
+            }
+
+            if (!it->value().is_string()) {
+                throw std::invalid_argument("Field \"move\" must be an string");
+            }
+
+            const std::string_view dir = it->value().get_string();
+
+            if (!dir.empty() && dir != "U" && dir != "D" && dir != "L" && dir != "R") {
+                throw std::invalid_argument("Invalid Direction");
+            }
+
+            if (!app_.PushPlayerAction(token, dir)) {
+                socket->Send(MakeError("unknownToken"sv, "Player token has not been found"sv));
+                socket->Close(http_server::websocket::close_code::policy_error);
+            }
+        } catch (const std::exception& ex) {
+            socket->Send(MakeError("invalidArgument"sv, "Failed to parse action: "s + ex.what()));
+        }
+    }
+} //namespace http_handler
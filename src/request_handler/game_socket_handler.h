@@ -0,0 +1,49 @@
+#pragma once
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+#include <memory>
+#include <optional>
+
+#include "model.h"
+#include "application.h"
+#include "common_type.h"
+#include "websocket_session.h"
+#include "state_broadcaster.h"
+
+namespace http_handler {
+    namespace net = boost::asio;
+
+    /*
+     * WebSocket-канал /api/v1/game/socket. После подключения клиент получает
+     * полное состояние сессии, а дальше после каждого тика - только изменения.
+     * Изменения сериализуются один раз на сессию и рассылаются всем подписчикам.
+     * Входящие сообщения {"move": "L"} ставятся в очередь команд, как и
+     * /api/v1/game/player/action
+     */
+    class GameSocketHandler {
+    public:
+        using Strand = net::strand<net::io_context::executor_type>;
+
+        GameSocketHandler(model::Game& game, app::Application& app, Strand strand);
+
+        GameSocketHandler(const GameSocketHandler&) = delete;
+        GameSocketHandler& operator=(const GameSocketHandler&) = delete;
+
+        /*
+         * Обработчик апгрейда для http_server. Забирает поток, только если запрос
+         * пришёл на SOCKET с действующим токеном, иначе запрос уходит в ApiHandler
+         */
+        bool operator()(const StringRequest& req, beast::tcp_stream& stream);
+
+        // Вызывается по сигналу тика игры, рассылка выполняется в strand_
+        void OnTick();
+    private:
+        app::Application& app_;
+        Strand strand_;
+        StateBroadcaster<http_server::WebSocketSession> broadcaster_;
+    private:
+        static std::optional<app::TokenKey> ExtractToken(const StringRequest& req);
+
+        void HandleMessage(const std::shared_ptr<http_server::WebSocketSession>& socket, app::TokenKey token, std::string_view message);
+    };
+} //namespace http_handler
@@ -28,10 +28,10 @@ namespace http_handler {
     private:
         template <typename Body, typename Allocator> 
         void LogRequest(const http::request<Body, http::basic_fields<Allocator>>& req, const std::string& client_ip) {
-            logger::Logger::LogInfo("request received"s, 
-                "ip"s , client_ip,
-                "URI"s, std::string(req.target()),
-                "method"s, std::string(req.method_string())
+            logger::Logger::LogInfo("request received"sv, 
+                "ip"sv , client_ip,
+                "URI"sv, req.target(),
+                "method"sv, req.method_string()
             );
         }
         template<typename Response>
@@ -39,16 +39,16 @@ namespace http_handler {
             auto end_time = std::chrono::steady_clock::now();
             auto response_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
 
-            std::string content_type = "null"s;
+            std::string_view content_type = "null"sv;
 
-            if (res.find(http::field::content_type) != res.end()) {
-                content_type = std::string(res[http::field::content_type]);
+            if (auto it = res.find(http::field::content_type); it != res.end()) {
+                content_type = it->value();
             }
 
-            logger::Logger::LogInfo("response sent"s,
-                "response_time"s, response_time,
-                "code"s, static_cast<int>(res.result()),
-                "content_type"s, content_type
+            logger::Logger::LogInfo("response sent"sv,
+                "response_time"sv, response_time,
+                "code"sv, static_cast<int>(res.result()),
+                "content_type"sv, content_type
             );
         }
     };
@@ -0,0 +1,49 @@
+#pragma once
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace http_handler {
+    /*
+     * Параметры строки запроса "a=1&b=2" без копирования: ключи и значения -
+     * подстроки исходного адреса, поэтому объект действителен, пока жив запрос.
+     * Параметры без '=' пропускаются, при повторе ключа побеждает последний
+     */
+    class QueryString {
+    public:
+        constexpr explicit QueryString(std::string_view query)
+            : query_{query} {
+        }
+
+        constexpr std::optional<std::string_view> Find(std::string_view key) const {
+            std::optional<std::string_view> result;
+            std::string_view rest = query_;
+            while (!rest.empty()) {
+                auto amp = rest.find('&');
+                auto pair = rest.substr(0, amp);
+                rest = amp == std::string_view::npos ? std::string_view{} : rest.substr(amp + 1);
+
+                auto equal_pos = pair.find('=');
+                if (equal_pos != std::string_view::npos && pair.substr(0, equal_pos) == key) {
+                    result = pair.substr(equal_pos + 1);
+                }
+            }
+            return result;
+        }
+
+        // Значение целиком должно быть числом, иначе std::nullopt
+        template <typename Integer>
+        static std::optional<Integer> ParseNumber(std::string_view value) {
+            static_assert(std::is_integral_v<Integer>);
+            Integer number{};
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (value.empty() || ec != std::errc{} || ptr != value.data() + value.size()) {
+                return std::nullopt;
+            }
+            return number;
+        }
+    private:
+        std::string_view query_;
+    };
+} //namespace http_handler
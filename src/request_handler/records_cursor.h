@@ -0,0 +1,119 @@
+#pragma once
+#include "data_transfer_object.h"
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace http_handler {
+    /*
+     * Курсор /records (параметр after): ключ порядка выдачи последнего
+     * полученного рекорда - score, play_time_ms, id и name. Для клиента курсор
+     * непрозрачен: это hex-запись строки "score,play_time_ms,id,name", поэтому
+     * он не требует экранирования в адресе. name стоит последним и может
+     * содержать запятые
+     */
+    namespace records_cursor {
+        namespace detail {
+            constexpr std::string_view HEX_DIGITS = "0123456789abcdef";
+
+            constexpr int HexValue(char c) {
+                if (c >= '0' && c <= '9') {
+                    return c - '0';
+                }
+                if (c >= 'a' && c <= 'f') {
+                    return c - 'a' + 10;
+                }
+                if (c >= 'A' && c <= 'F') {
+                    return c - 'A' + 10;
+                }
+                return -1;
+            }
+
+            // UUID в каноническом виде, как его выводит PostgreSQL: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+            constexpr bool IsCanonicalUuid(std::string_view id) {
+                if (id.size() != 36) {
+                    return false;
+                }
+                for (size_t i = 0; i < id.size(); ++i) {
+                    const bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+                    if (dash ? id[i] != '-' : HEX_DIGITS.find(id[i]) == std::string_view::npos) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // Число до запятой. Сдвигает text за запятую
+            inline std::optional<int64_t> TakeNumber(std::string_view& text) {
+                auto comma = text.find(',');
+                if (comma == std::string_view::npos) {
+                    return std::nullopt;
+                }
+                int64_t number = 0;
+                auto [ptr, ec] = std::from_chars(text.data(), text.data() + comma, number);
+                if (ec != std::errc{} || ptr != text.data() + comma) {
+                    return std::nullopt;
+                }
+                text.remove_prefix(comma + 1);
+                return number;
+            }
+        } // namespace detail
+
+        inline std::string Encode(const DTO::Score& score) {
+            std::string plain = std::to_string(score.score);
+            plain += ',';
+            plain += std::to_string(score.play_time_ms);
+            plain += ',';
+            plain += score.id;
+            plain += ',';
+            plain += score.name;
+
+            std::string cursor;
+            cursor.reserve(plain.size() * 2);
+            for (unsigned char c : plain) {
+                cursor += detail::HEX_DIGITS[c >> 4];
+                cursor += detail::HEX_DIGITS[c & 0xF];
+            }
+            return cursor;
+        }
+
+        // std::nullopt, если курсор повреждён
+        inline std::optional<DTO::Score> Decode(std::string_view cursor) {
+            if (cursor.empty() || cursor.size() % 2 != 0) {
+                return std::nullopt;
+            }
+
+            std::string plain;
+            plain.reserve(cursor.size() / 2);
+            for (size_t i = 0; i < cursor.size(); i += 2) {
+                const int high = detail::HexValue(cursor[i]);
+                const int low = detail::HexValue(cursor[i + 1]);
+                if (high < 0 || low < 0) {
+                    return std::nullopt;
+                }
+                plain += static_cast<char>(high << 4 | low);
+            }
+
+            std::string_view rest = plain;
+            auto score = detail::TakeNumber(rest);
+            auto play_time_ms = detail::TakeNumber(rest);
+            if (!score || !play_time_ms) {
+                return std::nullopt;
+            }
+
+            auto comma = rest.find(',');
+            if (comma == std::string_view::npos || !detail::IsCanonicalUuid(rest.substr(0, comma))) {
+                return std::nullopt;
+            }
+
+            return DTO::Score{
+                .name = std::string(rest.substr(comma + 1)),
+                .score = *score,
+                .play_time_ms = *play_time_ms,
+                .id = std::string(rest.substr(0, comma))
+            };
+        }
+    } // namespace records_cursor
+} // namespace http_handler
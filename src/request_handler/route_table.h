@@ -0,0 +1,163 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+#include "common_type.h"
+
+namespace http_handler {
+    enum class Route : uint8_t {
+        UNKNOWN,
+        MAPS,
+        MAP_BY_ID,
+        JOIN_GAME,
+        PLAYERS,
+        STATE,
+        PLAYER_ACTION,
+        TICK,
+        RECORDS,
+        SOCKET
+    };
+
+    // Набор HTTP-методов в виде битовой маски по http::verb
+    class VerbSet {
+    public:
+        constexpr VerbSet(std::initializer_list<http::verb> verbs) {
+            for (auto verb : verbs) {
+                mask_ |= Bit(verb);
+            }
+        }
+
+        constexpr bool Contains(http::verb verb) const {
+            return (mask_ & Bit(verb)) != 0;
+        }
+    private:
+        uint64_t mask_ = 0;
+    private:
+        constexpr static uint64_t Bit(http::verb verb) {
+            return uint64_t{1} << static_cast<unsigned>(verb);
+        }
+    };
+
+    struct RouteInfo {
+        Route route = Route::UNKNOWN;
+        std::string_view path;
+        VerbSet verbs;
+        // Значение заголовка Allow для ответа 405
+        std::string_view allow;
+
+        constexpr bool Allows(http::verb verb) const {
+            return verbs.Contains(verb);
+        }
+    };
+
+    // Результат разбора адреса запроса
+    struct RouteMatch {
+        const RouteInfo* info;
+        // Путь без строки запроса
+        std::string_view path;
+        // Строка запроса без '?'
+        std::string_view query;
+
+        constexpr Route GetRoute() const {
+            return info->route;
+        }
+    };
+
+    namespace routes {
+        inline constexpr RouteInfo UNKNOWN_ROUTE{Route::UNKNOWN, ""sv, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD};
+        // /api/v1/maps/{id} - единственный адрес с параметром, проверяется по префиксу
+        inline constexpr RouteInfo MAP_BY_ID_ROUTE{Route::MAP_BY_ID, Endpoints::MAP_BY_ID, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD};
+
+        // Адреса, которые сравниваются целиком
+        inline constexpr std::array EXACT_ROUTES{
+            RouteInfo{Route::MAPS, Endpoints::MAPS, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD},
+            RouteInfo{Route::JOIN_GAME, Endpoints::JOIN_GAME, {http::verb::post}, AllowedMethod::POST},
+            RouteInfo{Route::PLAYERS, Endpoints::PLAYERS, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD},
+            RouteInfo{Route::STATE, Endpoints::STATE, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD},
+            RouteInfo{Route::PLAYER_ACTION, Endpoints::PLAYER_ACTION, {http::verb::post}, AllowedMethod::POST},
+            RouteInfo{Route::TICK, Endpoints::TICK, {http::verb::post}, AllowedMethod::POST},
+            RouteInfo{Route::RECORDS, Endpoints::RECORDS, {http::verb::get, http::verb::head}, AllowedMethod::GET_HEAD},
+            RouteInfo{Route::SOCKET, Endpoints::SOCKET, {http::verb::get}, AllowedMethod::GET}
+        };
+
+        namespace detail {
+            constexpr size_t TABLE_SIZE = 32;
+            static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0, "TABLE_SIZE must be a power of two");
+            static_assert(EXACT_ROUTES.size() < TABLE_SIZE);
+
+            // FNV-1a с затравкой
+            constexpr uint32_t Hash(std::string_view str, uint32_t seed) {
+                uint32_t hash = 2166136261u ^ seed;
+                for (char c : str) {
+                    hash ^= static_cast<unsigned char>(c);
+                    hash *= 16777619u;
+                }
+                return hash;
+            }
+
+            constexpr size_t Slot(std::string_view path, uint32_t seed) {
+                return Hash(path, seed) & (TABLE_SIZE - 1);
+            }
+
+            // Подбирает затравку, при которой все адреса попадают в разные ячейки
+            constexpr uint32_t FindSeed() {
+                for (uint32_t seed = 0; seed < 100000; ++seed) {
+                    std::array<bool, TABLE_SIZE> used{};
+                    bool collision = false;
+                    for (const auto& route : EXACT_ROUTES) {
+                        auto slot = Slot(route.path, seed);
+                        collision = collision || used[slot];
+                        used[slot] = true;
+                    }
+                    if (!collision) {
+                        return seed;
+                    }
+                }
+                throw "Perfect hash seed has not been found";
+            }
+
+            constexpr uint32_t SEED = FindSeed();
+
+            // Номер маршрута в EXACT_ROUTES, увеличенный на 1; 0 - пустая ячейка
+            constexpr std::array<uint8_t, TABLE_SIZE> MakeTable() {
+                std::array<uint8_t, TABLE_SIZE> table{};
+                for (size_t i = 0; i < EXACT_ROUTES.size(); ++i) {
+                    table[Slot(EXACT_ROUTES[i].path, SEED)] = static_cast<uint8_t>(i + 1);
+                }
+                return table;
+            }
+
+            constexpr auto TABLE = MakeTable();
+        } //namespace detail
+
+        // Строка запроса без '?', пустая, если её нет
+        constexpr std::string_view QueryOf(std::string_view target) {
+            auto pos = target.find('?');
+            return pos == std::string_view::npos ? std::string_view{} : target.substr(pos + 1);
+        }
+
+        /*
+         * Находит маршрут за один проход хеша и не более двух сравнений строк
+         * независимо от числа адресов. Память не выделяется
+         */
+        constexpr RouteMatch Match(std::string_view target) {
+            std::string_view path = target.substr(0, target.find('?'));
+            std::string_view query = QueryOf(target);
+
+            if (auto index = detail::TABLE[detail::Slot(path, detail::SEED)]; index != 0) {
+                const auto& route = EXACT_ROUTES[index - 1];
+                if (route.path == path) {
+                    return {&route, path, query};
+                }
+            }
+
+            if (path.size() > Endpoints::MAP_BY_ID.size() && path.starts_with(Endpoints::MAP_BY_ID)) {
+                return {&MAP_BY_ID_ROUTE, path, query};
+            }
+
+            return {&UNKNOWN_ROUTE, path, query};
+        }
+    } //namespace routes
+} //namespace http_handler
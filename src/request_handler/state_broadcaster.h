@@ -0,0 +1,138 @@
+#pragma once
+#include <boost/beast/websocket/rfc6455.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "model.h"
+#include "application.h"
+#include "state_json.h"
+#include "logger.h"
+
+namespace http_handler {
+    using namespace std::literals;
+
+    /*
+     * Подписчики WebSocket-канала, сгруппированные по сессиям.
+     * Тип сокета - параметр шаблона: от него нужны только Send(Message)
+     * и Close(close_code), поэтому рассылку можно проверить без сети
+     */
+    template <typename Socket>
+    class StateBroadcaster {
+    public:
+        using Message = std::shared_ptr<const std::string>;
+        using CloseCode = boost::beast::websocket::close_code;
+
+        StateBroadcaster(const model::Game& game, app::Application& app)
+            : app_{app} {
+            for (const auto& [map_id, session] : game.GetSessions()) {
+                channels_.emplace(&session, std::make_unique<Channel>());
+            }
+        }
+
+        StateBroadcaster(const StateBroadcaster&) = delete;
+        StateBroadcaster& operator=(const StateBroadcaster&) = delete;
+
+        void Subscribe(const app::Application::SessionView& view, const std::shared_ptr<Socket>& socket, app::TokenKey token) {
+            auto& channel = *channels_.at(view.session);
+            std::lock_guard<std::mutex> lock(channel.mtx);
+
+            // Сначала полное состояние, дальше подписчик получает изменения от этой версии
+            socket->Send(std::make_shared<const std::string>(state_json::MakeFullState(view)));
+            channel.subscribers.push_back(Subscriber{
+                .socket = socket,
+                .token = token,
+                .version = view.snapshot->version
+            });
+
+            logger::Logger::LogInfo("websocket connected"s,
+                "subscribers"s, channel.subscribers.size()
+            );
+        }
+
+        void Unsubscribe(const model::GameSession* session, const Socket* socket) {
+            auto& channel = *channels_.at(session);
+            std::lock_guard<std::mutex> lock(channel.mtx);
+
+            std::erase_if(channel.subscribers, [socket](const Subscriber& subscriber) {
+                auto ptr = subscriber.socket.lock();
+                return ptr == nullptr || ptr.get() == socket;
+            });
+
+            logger::Logger::LogInfo("websocket disconnected"s,
+                "subscribers"s, channel.subscribers.size()
+            );
+        }
+
+        /*
+         * Подписчики одной сессии обычно находятся на одной версии, поэтому
+         * изменения для каждой встреченной версии сериализуются один раз
+         */
+        void Broadcast() {
+            std::vector<std::pair<uint64_t, Message>> messages;
+
+            for (auto& [session, channel] : channels_) {
+                std::lock_guard<std::mutex> lock(channel->mtx);
+                if (channel->subscribers.empty()) {
+                    continue;
+                }
+
+                const auto view = app_.GetSessionView(session);
+                const uint64_t version = view.snapshot->version;
+                messages.clear();
+
+                auto& subscribers = channel->subscribers;
+                for (auto it = subscribers.begin(); it != subscribers.end();) {
+                    auto socket = it->socket.lock();
+                    if (socket == nullptr) {
+                        it = subscribers.erase(it);
+                        continue;
+                    }
+
+                    if (it->version != version) {
+                        auto message = std::find_if(messages.begin(), messages.end(), [since = it->version](const auto& message) {
+                            return message.first == since;
+                        });
+                        if (message == messages.end()) {
+                            auto body = std::make_shared<const std::string>(state_json::MakeStateDelta(view, it->version));
+                            message = messages.emplace(messages.end(), it->version, std::move(body));
+                        }
+
+                        socket->Send(message->second);
+                        it->version = version;
+                    }
+
+                    // Игрок покинул игру по таймауту: он уже есть в removedPlayers последнего сообщения
+                    if (app_.FindSessionByToken(it->token) == nullptr) {
+                        socket->Close(CloseCode::policy_error);
+                        it = subscribers.erase(it);
+                        continue;
+                    }
+
+                    ++it;
+                }
+            }
+        }
+    private:
+        struct Subscriber {
+            std::weak_ptr<Socket> socket;
+            app::TokenKey token;
+            // Последняя отправленная версия снимка
+            uint64_t version = 0;
+        };
+
+        struct Channel {
+            std::mutex mtx;
+            std::vector<Subscriber> subscribers;
+        };
+
+        app::Application& app_;
+        // Набор сессий не меняется после загрузки, ключи заводятся в конструкторе
+        std::unordered_map<const model::GameSession*, std::unique_ptr<Channel>> channels_;
+    };
+} //namespace http_handler
@@ -0,0 +1,66 @@
+#include "state_delta.h"
+
+#include <algorithm>
+
+
+namespace http_handler {
+    std::optional<StateDelta> CollectStateDelta(const app::Application::SessionView& view, uint64_t since) {
+        const auto& snapshot = *view.snapshot;
+        const auto& history = snapshot.history;
+
+        // since=0 - у клиента ещё нет состояния, он явно просит полное
+        if (since == 0 || since > snapshot.version || (since < snapshot.version && (history.empty() || since + 1 < history.front()->version))) {
+            return std::nullopt;
+        }
+
+        std::vector<uint64_t> dog_ids;
+        std::vector<int> loot_ids;
+        for (const auto& changes : history) {
+            if (changes->version <= since) {
+                continue;
+            }
+            for (const auto& id : changes->changed_dogs) {
+                dog_ids.push_back(*id);
+            }
+            for (const auto& id : changes->removed_dogs) {
+                dog_ids.push_back(*id);
+            }
+            loot_ids.insert(loot_ids.end(), changes->added_loot.begin(), changes->added_loot.end());
+            loot_ids.insert(loot_ids.end(), changes->removed_loot.begin(), changes->removed_loot.end());
+        }
+
+        std::sort(dog_ids.begin(), dog_ids.end());
+        dog_ids.erase(std::unique(dog_ids.begin(), dog_ids.end()), dog_ids.end());
+        std::sort(loot_ids.begin(), loot_ids.end());
+        loot_ids.erase(std::unique(loot_ids.begin(), loot_ids.end()), loot_ids.end());
+
+        StateDelta delta;
+        for (auto id : dog_ids) {
+            const model::Dog::Id dog_id{id};
+            const auto* dog = snapshot.FindDog(dog_id);
+
+            if (const auto* player = view.players->Find(dog_id); player != nullptr && dog != nullptr) {
+                delta.players.push_back({player->id, dog});
+            } else if (const auto* departed = view.departed->Find(dog_id)) {
+                delta.removed_players.push_back(departed->id);
+            } else if (player == nullptr) {
+                // Игрок ушёл слишком давно, сопоставить собаку не с чем
+                return std::nullopt;
+            }
+        }
+
+        for (auto id : loot_ids) {
+            auto it = std::lower_bound(snapshot.loot_in_map.begin(), snapshot.loot_in_map.end(), id, [](const model::Loot& loot, int id) {
+                return loot.id < id;
+            });
+
+            if (it != snapshot.loot_in_map.end() && it->id == id) {
+                delta.loot.push_back(&*it);
+            } else {
+                delta.removed_loot.push_back(id);
+            }
+        }
+
+        return delta;
+    }
+} //namespace http_handler
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "application.h"
+
+namespace http_handler {
+    /*
+     * Изменения состояния сессии после версии since, уже сопоставленные с игроками.
+     * Указатели ссылаются на снимок из SessionView и живут, пока жив снимок.
+     * Формат ответа (JSON или бинарный) строится поверх этой структуры
+     */
+    struct StateDelta {
+        struct PlayerState {
+            app::Player::Id id;
+            const model::DogSnapshot* dog;
+        };
+
+        std::vector<PlayerState> players;
+        std::vector<app::Player::Id> removed_players;
+        std::vector<const model::Loot*> loot;
+        std::vector<int> removed_loot;
+    };
+
+    // nullopt - since=0 или нужных наборов изменений уже нет в истории, клиенту нужно полное состояние
+    std::optional<StateDelta> CollectStateDelta(const app::Application::SessionView& view, uint64_t since);
+} //namespace http_handler
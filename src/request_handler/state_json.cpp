@@ -0,0 +1,183 @@
+#include "state_json.h"
+#include "state_delta.h"
+
+#include <boost/json.hpp>
+
+
+namespace json = boost::json;
+
+namespace http_handler::state_json {
+    using namespace std::literals;
+    namespace detail {
+        namespace serialize {
+            json::array SerializePosition(model::Position pos) {
+                return json::array{pos.x, pos.y};
+            }
+
+            json::array SerializeSpeed(model::Speed speed) {
+                return json::array{speed.h_speed, speed.v_speed};
+            }
+
+            const std::string& SerializeDirection(model::Direction dir) {
+                static const std::string UP = "U"s;
+                static const std::string DOWN = "D"s;
+                static const std::string LEFT = "L"s;
+                static const std::string RIGHT = "R"s;
+                static const std::string UNKNOWN = "unknown dir"s;
+
+                switch (dir) {
+                case model::Direction::NORTH:
+                    return UP;
+                    break;
+                case model::Direction::SOUTH:
+                    return DOWN;
+                    break;
+                case model::Direction::WEST:
+                    return LEFT;
+                    break;
+                case model::Direction::EAST:
+                    return RIGHT;
+                    break;
+                default:
+                    return UNKNOWN;
+                    break;
+                }
+            }
+
+            json::object SerializeLootBag(const model::Loot& loot) {
+                return json::object{
+                    {"type", loot.type},
+                    {"id", loot.id}
+                };
+            }
+
+            json::object SerializeLootMap(const model::Loot& loot) {
+                return json::object{
+                    {"type", loot.type},
+                    {"pos", SerializePosition(loot.pos)}
+                };
+            }
+
+            json::array SerializeBag(const model::Dog::Bag& bag) {
+                json::array res;
+
+                for(const auto& loot : bag) {
+                    res.emplace_back(SerializeLootBag(loot));
+                }
+
+                return res;
+            }
+
+            json::object SerializeDog(const model::DogSnapshot& dog) {
+                return json::object {
+                    {"pos", SerializePosition(dog.pos)},
+                    {"speed", SerializeSpeed(dog.speed)},
+                    {"dir", SerializeDirection(dog.dir)},
+                    {"bag", SerializeBag(dog.bag)},
+                    {"score", dog.score}
+                };
+            }
+
+            json::object SerializeLootsMap(const std::vector<model::Loot>& loot_in_map) {
+                size_t size = loot_in_map.size();
+                json::object lost_object;
+
+                for (size_t i = 0; i < size; ++i) {
+                    lost_object[std::to_string(i)] = SerializeLootMap(loot_in_map[i]);
+                }
+
+                return lost_object;
+            }
+
+            // В ответах с изменениями лут адресуется по id, т.к. индексы сдвигаются при подборе
+            json::object SerializeLootsById(const std::vector<model::Loot>& loot_in_map) {
+                json::object lost_object;
+
+                for (const auto& loot : loot_in_map) {
+                    lost_object[std::to_string(loot.id)] = SerializeLootMap(loot);
+                }
+
+                return lost_object;
+            }
+        } //namespace serialize
+    } //namespace detail
+
+    std::string MakeState(const app::Application::SessionView& view) {
+        const auto& snapshot = *view.snapshot;
+        json::object players_json;
+        for (const auto& p : *view.players) {
+            // Собака вошедшего игрока появится в следующем снимке
+            if (const auto* dog = snapshot.FindDog(p.dog_id)) {
+                players_json[std::to_string(p.id)] = detail::serialize::SerializeDog(*dog);
+            }
+        }
+
+        json::object state_json {
+            {"players", std::move(players_json)},
+            {"lostObjects", detail::serialize::SerializeLootsMap(snapshot.loot_in_map)}
+        };
+
+        return json::serialize(state_json);
+    }
+
+    std::string MakeFullState(const app::Application::SessionView& view) {
+        const auto& snapshot = *view.snapshot;
+        json::object players_json;
+        for (const auto& p : *view.players) {
+            if (const auto* dog = snapshot.FindDog(p.dog_id)) {
+                players_json[std::to_string(p.id)] = detail::serialize::SerializeDog(*dog);
+            }
+        }
+
+        json::object state_json {
+            {"tick", snapshot.version},
+            {"full", true},
+            {"players", std::move(players_json)},
+            {"lostObjects", detail::serialize::SerializeLootsById(snapshot.loot_in_map)}
+        };
+
+        return json::serialize(state_json);
+    }
+
+    /*
+     * Собирает изменения снимка после версии since. Если нужных наборов
+     * изменений уже нет в истории, возвращает полное состояние
+     */
+    std::string MakeStateDelta(const app::Application::SessionView& view, uint64_t since) {
+        auto delta = CollectStateDelta(view, since);
+        if (!delta) {
+            return MakeFullState(view);
+        }
+
+        json::object players_json;
+        for (const auto& player : delta->players) {
+            players_json[std::to_string(player.id)] = detail::serialize::SerializeDog(*player.dog);
+        }
+
+        json::array removed_players;
+        for (auto id : delta->removed_players) {
+            removed_players.emplace_back(id);
+        }
+
+        json::object lost_objects;
+        for (const auto* loot : delta->loot) {
+            lost_objects[std::to_string(loot->id)] = detail::serialize::SerializeLootMap(*loot);
+        }
+
+        json::array removed_lost_objects;
+        for (auto id : delta->removed_loot) {
+            removed_lost_objects.emplace_back(id);
+        }
+
+        json::object state_json {
+            {"tick", view.snapshot->version},
+            {"full", false},
+            {"players", std::move(players_json)},
+            {"removedPlayers", std::move(removed_players)},
+            {"lostObjects", std::move(lost_objects)},
+            {"removedLostObjects", std::move(removed_lost_objects)}
+        };
+
+        return json::serialize(state_json);
+    }
+} //namespace http_handler::state_json
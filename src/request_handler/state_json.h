@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "application.h"
+
+/*
+ * Сериализация состояния сессии в JSON. Используется и HTTP API,
+ * и WebSocket-каналом, поэтому вынесена из ApiHandler
+ */
+namespace http_handler::state_json {
+    // Полное состояние в исходном формате /api/v1/game/state (лут адресуется по индексу)
+    std::string MakeState(const app::Application::SessionView& view);
+
+    // Полное состояние в формате изменений: "full": true, лут адресуется по id
+    std::string MakeFullState(const app::Application::SessionView& view);
+
+    // Изменения после версии since, либо полное состояние, если история уже потеряна
+    std::string MakeStateDelta(const app::Application::SessionView& view, uint64_t since);
+} //namespace http_handler::state_json
@@ -0,0 +1,234 @@
+#include "static_cache.h"
+#include "common_type.h"
+#include "etag.h"
+
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace http_handler {
+    namespace detail {
+        std::string_view DefinitionContentType(std::string_view target) {
+            auto idx = target.find_last_of('.');
+            if (idx == std::string_view::npos) {
+                return ContentType::APP_BIN;
+            }
+            auto type = target.substr(idx);
+            // Создаем временную строку в нижнем регистре
+            std::string lower_type(type);
+            std::transform(lower_type.begin(), lower_type.end(), lower_type.begin(),
+                        [](unsigned char c) { return std::tolower(c); });
+
+            if(lower_type == ".htm"s || lower_type == ".html"s){
+                return ContentType::TEXT_HTML;
+            }
+
+            if(lower_type == ".css"s) {
+                return ContentType::TEXT_CSS;
+            }
+
+            if(lower_type == ".txt"s) {
+                return ContentType::TEXT_TXT;
+            }
+
+            if(lower_type == ".js"s) {
+                return ContentType::TEXT_JS;
+            }
+
+            if(lower_type == ".json"s) {
+                return ContentType::APP_JSON;
+            }
+
+            if(lower_type == ".xml"s) {
+                return ContentType::APP_XML;
+            }
+
+            if(lower_type == ".png"s) {
+                return ContentType::IMG_PNG;
+            }
+
+            if(lower_type == ".jpg"s || lower_type == ".jpe"s || lower_type == ".jpeg"s) {
+                return ContentType::IMG_JPG;
+            }
+
+            if(lower_type == ".gif"s) {
+                return ContentType::IMG_GIF;
+            }
+
+            if(lower_type == ".bmp"s) {
+                return ContentType::IMG_BMP;
+            }
+
+            if(lower_type == ".ico"s) {
+                return ContentType::IMG_ICO;
+            }
+
+            if(lower_type == ".tiff"s || lower_type == ".tif"s) {
+                return ContentType::IMG_TIF;
+            }
+
+            if(lower_type == ".svg"s || lower_type == ".svgz"s) {
+                return ContentType::IMG_SVG;
+            }
+
+            if(lower_type == ".mp3"s) {
+                return ContentType::AUDIO_MP3;
+            }
+
+            return ContentType::APP_BIN;
+        }
+
+        // Уже сжатые форматы повторно не сжимаем
+        bool IsCompressible(std::string_view content_type) {
+            return content_type != ContentType::IMG_PNG
+                && content_type != ContentType::IMG_JPG
+                && content_type != ContentType::IMG_GIF
+                && content_type != ContentType::AUDIO_MP3;
+        }
+
+        std::string Gzip(std::string_view data) {
+            namespace io = boost::iostreams;
+
+            std::string result;
+            {
+                io::filtering_ostream out;
+                out.push(io::gzip_compressor(io::gzip_params(io::gzip::best_compression)));
+                out.push(io::back_inserter(result));
+                out.write(data.data(), static_cast<std::streamsize>(data.size()));
+                // Остаток сжатых данных дописывается при закрытии потока
+            }
+            return result;
+        }
+
+        std::string ReadFile(const fs::path& path, uintmax_t size) {
+            std::ifstream file(path, std::ios::binary);
+            std::string content(size, '\0');
+            if (!file.read(content.data(), static_cast<std::streamsize>(size))) {
+                throw std::runtime_error("Not found file");
+            }
+            return content;
+        }
+    } //namespace detail
+
+    StaticCache::StaticCache(fs::path base_path)
+        : base_path_{fs::weakly_canonical(base_path)} {
+    }
+
+    std::shared_ptr<const StaticAsset> StaticCache::Find(std::string_view target) {
+        auto key = NormalizeTarget(target);
+        {
+            std::shared_lock lock(mtx_);
+            if (auto it = assets_.find(key); it != assets_.end()) {
+                return it->second;
+            }
+        }
+
+        // Загрузка идёт без блокировки: при одновременном промахе файл прочитают
+        // несколько потоков, в кэше останется первый результат
+        auto asset = Load(key);
+
+        std::unique_lock lock(mtx_);
+        return assets_.emplace(std::move(key), std::move(asset)).first->second;
+    }
+
+    std::string StaticCache::NormalizeTarget(std::string_view target) {
+        target = target.substr(0, target.find('?'));
+        if (target == "/"sv || target.empty()) {
+            target = "/index.html"sv;
+        }
+
+        // Выход за корень ("/../x") - ошибка запроса, а не отсутствующий файл
+        auto relative = fs::path(target.substr(1)).lexically_normal();
+        if (!relative.empty() && *relative.begin() == "..") {
+            throw std::runtime_error("Invalid path");
+        }
+
+        return "/"s + relative.generic_string();
+    }
+
+    std::shared_ptr<const StaticAsset> StaticCache::Load(const std::string& key) const {
+        auto path = base_path_ / fs::path(key).relative_path();
+        // Символические ссылки проверяются один раз, при загрузке
+        if (!IsSubPath(path)) {
+            throw std::runtime_error("Invalid path");
+        }
+
+        std::error_code ec;
+        if (!fs::is_regular_file(path, ec)) {
+            throw std::runtime_error("Not found file");
+        }
+
+        auto asset = std::make_shared<StaticAsset>();
+        asset->path = path;
+        asset->content_type = detail::DefinitionContentType(key);
+        asset->size = fs::file_size(path);
+        asset->modified = std::chrono::time_point_cast<std::chrono::seconds>(
+            std::chrono::file_clock::to_sys(fs::last_write_time(path)));
+        asset->last_modified = FormatHttpDate(asset->modified);
+
+        if (asset->size > MAX_CACHED_FILE_SIZE) {
+            std::ostringstream etag;
+            etag << '"' << std::hex << asset->size << '-'
+                 << std::chrono::system_clock::to_time_t(asset->modified) << '"';
+            asset->etag = etag.str();
+            return asset;
+        }
+
+        auto body = detail::ReadFile(path, asset->size);
+        asset->etag = MakeETag(body);
+
+        if (detail::IsCompressible(asset->content_type)) {
+            auto gzip_body = detail::Gzip(body);
+            // Сжатый вариант хранится, только если он заметно меньше
+            if (gzip_body.size() < body.size() / 10 * 9) {
+                asset->gzip_etag = MakeETag(gzip_body);
+                asset->gzip_body = std::make_shared<const std::string>(std::move(gzip_body));
+            }
+        }
+        asset->body = std::make_shared<const std::string>(std::move(body));
+
+        return asset;
+    }
+
+    // Возвращает true, если path содержится внутри base_path_
+    bool StaticCache::IsSubPath(const fs::path& path) const {
+        // Приводим путь к каноничному виду (без . и .. и символических ссылок)
+        auto canonical = fs::weakly_canonical(path);
+
+        // Проверяем, что все компоненты base содержатся внутри path
+        for (auto b = base_path_.begin(), p = canonical.begin(); b != base_path_.end(); ++b, ++p) {
+            if (p == canonical.end() || *p != *b) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string FormatHttpDate(std::chrono::system_clock::time_point time) {
+        std::time_t t = std::chrono::system_clock::to_time_t(time);
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+
+        char buffer[32];
+        auto size = std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        return std::string(buffer, size);
+    }
+
+    std::optional<std::chrono::system_clock::time_point> ParseHttpDate(std::string_view date) {
+        std::tm tm{};
+        std::istringstream iss{std::string(date)};
+        iss >> std::get_time(&tm, "%a, %d %b %Y %H:%M:%S GMT");
+        if (iss.fail()) {
+            return std::nullopt;
+        }
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    }
+} //namespace http_handler
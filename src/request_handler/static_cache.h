@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace http_handler {
+    namespace fs = std::filesystem;
+
+    // Файл из www_root вместе с заголовками и, если он небольшой, содержимым и сжатым вариантом
+    struct StaticAsset {
+        fs::path path;
+        std::string_view content_type;
+        uintmax_t size = 0;
+        // nullptr для файлов больше MAX_CACHED_FILE_SIZE, они отдаются с диска
+        std::shared_ptr<const std::string> body;
+        // Для файлов в памяти - хеш содержимого, для остальных - размер и время изменения
+        std::string etag;
+        // nullptr, если сжатие не дало выигрыша (например, для png)
+        std::shared_ptr<const std::string> gzip_body;
+        std::string gzip_etag;
+        std::chrono::system_clock::time_point modified;
+        // Значение заголовка Last-Modified (HTTP-date)
+        std::string last_modified;
+    };
+
+    /*
+     * Кэш статических файлов. Файл читается с диска и сжимается при первом
+     * обращении, дальше запрос обслуживается из памяти без системных вызовов.
+     * Ключ - нормализованный путь запроса. Предполагается, что файлы в www_root
+     * не меняются во время работы сервера
+     */
+    class StaticCache {
+    public:
+        // Содержимое файлов больше лимита в память не читается
+        constexpr static uintmax_t MAX_CACHED_FILE_SIZE = 4 * 1024 * 1024;
+
+        explicit StaticCache(fs::path base_path);
+
+        /*
+         * Возвращает файл по пути из запроса.
+         * Выбрасывает std::runtime_error("Invalid path"), если путь выходит за www_root,
+         * и std::runtime_error("Not found file"), если файла нет
+         */
+        std::shared_ptr<const StaticAsset> Find(std::string_view target);
+
+        // Нормализованный путь внутри www_root ("/" заменяется на "/index.html")
+        static std::string NormalizeTarget(std::string_view target);
+    private:
+        fs::path base_path_;
+        std::shared_mutex mtx_;
+        std::unordered_map<std::string, std::shared_ptr<const StaticAsset>> assets_;
+    private:
+        std::shared_ptr<const StaticAsset> Load(const std::string& key) const;
+        bool IsSubPath(const fs::path& path) const;
+    };
+
+    // Дата в формате HTTP (RFC 9110, IMF-fixdate): "Sun, 06 Nov 1994 08:49:37 GMT"
+    std::string FormatHttpDate(std::chrono::system_clock::time_point time);
+    std::optional<std::chrono::system_clock::time_point> ParseHttpDate(std::string_view date);
+} //namespace http_handler
@@ -1,129 +1,235 @@
 #include "static_handler.h"
+#include "etag.h"
+
+#include <charconv>
 
 namespace http_handler {
     
     namespace detail {
-        // Возвращает true, если каталог p содержится внутри base_path.
-        bool IsSubPath(fs::path path, fs::path base) {
-            // Приводим оба пути к каноничному виду (без . и ..)
-            path = fs::weakly_canonical(path);
-            base = fs::weakly_canonical(base);
-
-            // Проверяем, что все компоненты base содержатся внутри path
-            for (auto b = base.begin(), p = path.begin(); b != base.end(); ++b, ++p) {
-                if (p == path.end() || *p != *b) {
-                    return false;
-                }
+        bool AcceptsGzip(const StringRequest& req) {
+            auto header = req.find(http::field::accept_encoding);
+            if (header == req.end()) {
+                return false;
             }
-            return true;
-        }
 
-        std::string_view DefinitionContentType(std::string_view target) {
-            auto idx = target.find_last_of('.');
-            auto type = target.substr(idx);
-            // Создаем временную строку в нижнем регистре
-            std::string lower_type(type);
-            std::transform(lower_type.begin(), lower_type.end(), lower_type.begin(),
-                        [](unsigned char c) { return std::tolower(c); });
+            std::string_view value = header->value();
+            while (!value.empty()) {
+                auto comma = value.find(',');
+                auto coding = value.substr(0, comma);
+                value.remove_prefix(comma == std::string_view::npos ? value.size() : comma + 1);
 
-            if(lower_type == ".htm"s || lower_type == ".html"s){
-                return ContentType::TEXT_HTML;
-            }
+                auto params_pos = coding.find(';');
+                auto name = coding.substr(0, params_pos);
+                while (!name.empty() && name.front() == ' ') {
+                    name.remove_prefix(1);
+                }
+                while (!name.empty() && name.back() == ' ') {
+                    name.remove_suffix(1);
+                }
+                if (name != "gzip"sv && name != "*"sv) {
+                    continue;
+                }
 
-            if(lower_type == ".css"s) {
-                return ContentType::TEXT_CSS;
+                if (params_pos == std::string_view::npos) {
+                    return true;
+                }
+                auto params = coding.substr(params_pos + 1);
+                auto q_pos = params.find("q="sv);
+                if (q_pos == std::string_view::npos) {
+                    return true;
+                }
+                double q = 1.0;
+                auto q_value = params.substr(q_pos + 2);
+                std::from_chars(q_value.data(), q_value.data() + q_value.size(), q);
+                return q > 0.0;
             }
 
-            if(lower_type == ".txt"s) {
-                return ContentType::TEXT_TXT;
-            }
+            return false;
+        }
 
-            if(lower_type == ".js"s) {
-                return ContentType::TEXT_JS;
+        // If-None-Match важнее If-Modified-Since (RFC 9110, 13.1.3)
+        bool IsNotModified(const StringRequest& req, std::string_view etag, std::chrono::system_clock::time_point modified) {
+            if (auto if_none_match = req.find(http::field::if_none_match); if_none_match != req.end()) {
+                return MatchesETag(if_none_match->value(), etag);
             }
 
-            if(lower_type == ".json"s) {
-                return ContentType::APP_JSON;
+            if (auto if_modified_since = req.find(http::field::if_modified_since); if_modified_since != req.end()) {
+                auto since = ParseHttpDate(if_modified_since->value());
+                return since.has_value() && modified <= *since;
             }
 
-            if(lower_type == ".xml"s) {
-                return ContentType::APP_XML;
-            }
+            return false;
+        }
 
-            if(lower_type == ".png"s) {
-                return ContentType::IMG_PNG;
+        std::optional<uint64_t> ParseNumber(std::string_view str) {
+            uint64_t value = 0;
+            auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+            if (str.empty() || ec != std::errc{} || ptr != str.data() + str.size()) {
+                return std::nullopt;
             }
+            return value;
+        }
 
-            if(lower_type == ".jpg"s || lower_type == ".jpe"s || lower_type == ".jpeg"s) {
-                return ContentType::IMG_JPG;
-            }
+        std::string MakeContentRange(uint64_t offset, uint64_t length, uint64_t size) {
+            return "bytes "s + std::to_string(offset) + "-"s + std::to_string(offset + length - 1) + "/"s + std::to_string(size);
+        }
+
+        std::optional<ByteRange> GetRange(const StringRequest& req, const StaticAsset& asset) {
+            constexpr auto bytes_prefix = "bytes="sv;
 
-            if(lower_type == ".gif"s) {
-                return ContentType::IMG_GIF;
+            auto range_header = req.find(http::field::range);
+            if (range_header == req.end()) {
+                return std::nullopt;
             }
 
-            if(lower_type == ".bmp"s) {
-                return ContentType::IMG_BMP;
+            // If-Range: диапазон отдаётся, только если у клиента та же версия файла
+            if (auto if_range = req.find(http::field::if_range); if_range != req.end()) {
+                std::string_view validator = if_range->value();
+                if (validator != asset.etag && validator != asset.last_modified) {
+                    return std::nullopt;
+                }
             }
 
-            if(lower_type == ".ico"s) {
-                return ContentType::IMG_ICO;
+            std::string_view spec = range_header->value();
+            // Несколько диапазонов не поддерживаются, в этом случае отдаётся весь файл
+            if (!spec.starts_with(bytes_prefix) || spec.find(',') != std::string_view::npos) {
+                return std::nullopt;
             }
+            spec.remove_prefix(bytes_prefix.size());
 
-            if(lower_type == ".tiff"s || lower_type == ".tif"s) {
-                return ContentType::IMG_TIF;
+            auto dash = spec.find('-');
+            if (dash == std::string_view::npos) {
+                return std::nullopt;
             }
 
-            if(lower_type == ".svg"s || lower_type == ".svgz"s) {
-                return ContentType::IMG_SVG;
+            const uint64_t size = asset.size;
+            auto first = spec.substr(0, dash);
+            auto last = spec.substr(dash + 1);
+
+            if (first.empty()) {
+                // bytes=-N - последние N байт
+                auto suffix = ParseNumber(last);
+                if (!suffix.has_value()) {
+                    return std::nullopt;
+                }
+                if (*suffix == 0 || size == 0) {
+                    return ByteRange{};
+                }
+                auto length = std::min(*suffix, size);
+                return ByteRange{.offset = size - length, .length = length};
             }
 
-            if(lower_type == ".mp3"s) {
-                return ContentType::AUDIO_MP3;
+            auto offset = ParseNumber(first);
+            auto end = last.empty() ? std::optional<uint64_t>{size - 1} : ParseNumber(last);
+            if (!offset.has_value() || !end.has_value() || (!last.empty() && *end < *offset)) {
+                return std::nullopt;
+            }
+            if (*offset >= size) {
+                return ByteRange{};
             }
 
-            return ContentType::APP_BIN;
+            return ByteRange{.offset = *offset, .length = std::min(*end, size - 1) - *offset + 1};
         }
     } //namespace detail
 
-    FileResponse StaticHandler::HandleFileRequest(StringRequest&& req) {
-        FileResponse answer;
-        if(req.method() !=  http::verb::get && req.method() != http::verb::head) {
-            answer.result(http::status::bad_request);
-            answer.set(http::field::allow, "GET, HEAD"sv);
-        } else {
-            answer = GetFile(req);                    
-        }
-
+    StringResponse StaticHandler::MakeInvalidMethodResponse(const StringRequest& req) {
+        StringResponse answer(http::status::bad_request, req.version());
+        answer.set(http::field::allow, AllowedMethod::GET_HEAD);
+        answer.keep_alive(req.keep_alive());
+        answer.prepare_payload();
         return answer;
     }
 
-    FileResponse StaticHandler::GetFile(const StringRequest& req) const{
-        std::string target {req.target()};
-        if(target == "/"s || target.empty()){
-            target = "/index.html"s;
+    SharedResponse StaticHandler::MakeAssetResponse(const StringRequest& req, const StaticAsset& asset) {
+        const bool gzip = asset.gzip_body != nullptr && detail::AcceptsGzip(req);
+        const auto& etag = gzip ? asset.gzip_etag : asset.etag;
+
+        SharedResponse res(http::status::ok, req.version());
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::content_type, asset.content_type);
+        res.set(http::field::etag, etag);
+        res.set(http::field::last_modified, asset.last_modified);
+        res.set(http::field::accept_ranges, "bytes"sv);
+        if (asset.gzip_body != nullptr) {
+            res.set(http::field::vary, "Accept-Encoding"sv);
         }
 
-        auto path = base_path_.string() + target;
-        if (!detail::IsSubPath(path, base_path_)) {
-            throw std::runtime_error("Invalid path");
+        static const auto empty_body = std::make_shared<const std::string>();
+        if (detail::IsNotModified(req, etag, asset.modified)) {
+            res.result(http::status::not_modified);
+            res.body() = empty_body;
+            return res;
         }
 
-        http::file_body::value_type file;
-        beast::error_code ec;
-        file.open(path.data(), beast::file_mode::read, ec);
+        if (gzip) {
+            res.set(http::field::content_encoding, "gzip"sv);
+        }
+        const auto& body = gzip ? asset.gzip_body : asset.body;
+        res.content_length(body->size());
+        // На HEAD отдаём только заголовки
+        res.body() = req.method() == http::verb::head ? empty_body : body;
+
+        return res;
+    }
 
+    bool StaticHandler::IsNotModified(const StringRequest& req, const StaticAsset& asset) {
+        return detail::IsNotModified(req, asset.etag, asset.modified);
+    }
+
+    StringResponse StaticHandler::MakeNotModifiedResponse(const StringRequest& req, const StaticAsset& asset) {
+        StringResponse res(http::status::not_modified, req.version());
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::etag, asset.etag);
+        res.set(http::field::last_modified, asset.last_modified);
+        return res;
+    }
+
+    StringResponse StaticHandler::MakeRangeNotSatisfiable(const StringRequest& req, const StaticAsset& asset) {
+        StringResponse res(http::status::range_not_satisfiable, req.version());
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::content_range, "bytes */"s + std::to_string(asset.size));
+        res.prepare_payload();
+        return res;
+    }
+
+    StringResponse StaticHandler::MakePartialAssetResponse(const StringRequest& req, const StaticAsset& asset, ByteRange range) {
+        StringResponse res(http::status::partial_content, req.version());
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::content_type, asset.content_type);
+        res.set(http::field::etag, asset.etag);
+        res.set(http::field::last_modified, asset.last_modified);
+        res.set(http::field::accept_ranges, "bytes"sv);
+        res.set(http::field::content_range, detail::MakeContentRange(range.offset, range.length, asset.size));
+        res.content_length(range.length);
+        if (req.method() != http::verb::head) {
+            res.body().assign(*asset.body, range.offset, range.length);
+        }
+        return res;
+    }
+
+    FileRangeResponse StaticHandler::GetFile(const StringRequest& req, const StaticAsset& asset, std::optional<ByteRange> range) {
+        FileRangeResponse res(range.has_value() ? http::status::partial_content : http::status::ok, req.version());
+
+        beast::error_code ec;
+        res.body().Open(asset.path.c_str(), ec);
         if(ec) {
             throw std::runtime_error("Not found file");
         }
 
-        http::response<http::file_body> res;
-        res.version(req.version());
-        res.result(http::status::ok);
-        res.body() = std::move(file);
-        res.prepare_payload();
-        auto content_type = detail::DefinitionContentType(target);
-        res.set(http::field::content_type, content_type);
+        const auto offset = range.has_value() ? range->offset : 0;
+        const auto length = range.has_value() ? range->length : asset.size;
+        // На HEAD отдаём только заголовки
+        res.body().SetRange(offset, req.method() == http::verb::head ? 0 : length);
+        res.content_length(length);
+
+        res.keep_alive(req.keep_alive());
+        res.set(http::field::content_type, asset.content_type);
+        res.set(http::field::etag, asset.etag);
+        res.set(http::field::last_modified, asset.last_modified);
+        res.set(http::field::accept_ranges, "bytes"sv);
+        if (range.has_value()) {
+            res.set(http::field::content_range, detail::MakeContentRange(offset, length, asset.size));
+        }
 
         return res;
     }
@@ -1,23 +1,75 @@
 #pragma once
 #include <filesystem>
 #include "common_type.h"
+#include "static_cache.h"
+#include <optional>
 #include <string_view>
 
 namespace http_handler {
     namespace fs = std::filesystem;
     using namespace std::literals;
+
+    namespace detail {
+        struct ByteRange {
+            uint64_t offset = 0;
+            // 0 - диапазон невыполним
+            uint64_t length = 0;
+        };
+
+        // Клиент принимает gzip, если он указан в Accept-Encoding (или указан "*") без q=0
+        bool AcceptsGzip(const StringRequest& req);
+
+        /*
+         * Диапазон из заголовка Range (один диапазон байт) с учётом If-Range.
+         * nullopt - Range нет или его нужно проигнорировать и отдать файл целиком
+         */
+        std::optional<ByteRange> GetRange(const StringRequest& req, const StaticAsset& asset);
+        // Значение Content-Range для непустого диапазона
+        std::string MakeContentRange(uint64_t offset, uint64_t length, uint64_t size);
+    } //namespace detail
     
     class StaticHandler {
     public:
         explicit StaticHandler(fs::path base_path)
-        : base_path_{fs::weakly_canonical(base_path)} {
+        : cache_{base_path} {
 
         }
+        /*
+         * Небольшие файлы отдаются из StaticCache как разделяемая строка (при поддержке
+         * клиентом - сжатыми gzip), большие - с диска через sendfile.
+         * Поддерживаются условные запросы If-None-Match и If-Modified-Since
+         * и запрос одного диапазона байт (Range, If-Range)
+         */
         template <typename Body, typename Allocator, typename Send>
         void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send){
             try {
-                FileResponse response = HandleFileRequest(std::move(req));
-                send(std::move(response));
+                if(req.method() !=  http::verb::get && req.method() != http::verb::head) {
+                    send(MakeInvalidMethodResponse(req));
+                    return;
+                }
+
+                auto asset = cache_.Find(req.target());
+                auto range = detail::GetRange(req, *asset);
+                if (asset->body && !range.has_value()) {
+                    send(MakeAssetResponse(req, *asset));
+                    return;
+                }
+
+                // Условный запрос важнее Range
+                if (IsNotModified(req, *asset)) {
+                    send(MakeNotModifiedResponse(req, *asset));
+                    return;
+                }
+
+                if (!range.has_value()) {
+                    send(GetFile(req, *asset, std::nullopt));
+                } else if (range->length == 0) {
+                    send(MakeRangeNotSatisfiable(req, *asset));
+                } else if (asset->body) {
+                    send(MakePartialAssetResponse(req, *asset, *range));
+                } else {
+                    send(GetFile(req, *asset, range));
+                }
             } catch (std::exception& ex) {
                 StringResponse error;
                 
@@ -34,10 +86,17 @@ namespace http_handler {
             }  
         }
     private:
-        fs::path base_path_;
+        StaticCache cache_;
+
+        using ByteRange = detail::ByteRange;
     private:
-        FileResponse GetFile(const StringRequest& req) const;
-        FileResponse HandleFileRequest(StringRequest&& req);
+        static StringResponse MakeRangeNotSatisfiable(const StringRequest& req, const StaticAsset& asset);
+        static StringResponse MakePartialAssetResponse(const StringRequest& req, const StaticAsset& asset, ByteRange range);
+        static StringResponse MakeInvalidMethodResponse(const StringRequest& req);
+        static SharedResponse MakeAssetResponse(const StringRequest& req, const StaticAsset& asset);
+        static bool IsNotModified(const StringRequest& req, const StaticAsset& asset);
+        static StringResponse MakeNotModifiedResponse(const StringRequest& req, const StaticAsset& asset);
+        static FileRangeResponse GetFile(const StringRequest& req, const StaticAsset& asset, std::optional<ByteRange> range);
     };
 
-} //namespace http_handler
\ No newline at end of file
+} //namespace http_handler
@@ -33,7 +33,7 @@ namespace state_manager {
         app_repr.Restore(game, app);
     }
 
-    void SaveState(const std::filesystem::path& state_file, const model::Game& game, const app::Application& app) {
+    void SaveState(const std::filesystem::path& state_file, model::Game& game, const app::Application& app) {
         auto temp_path = state_file.parent_path() / ("temp-save-file"s + ".tmp"s);
 
         try {
@@ -41,8 +41,14 @@ namespace state_manager {
                 std::filesystem::create_directories(state_file.parent_path());
             }
             
-            serialization::GameRepr game_repr(game);
-            serialization::ApplicationRepr app_repr(app);
+            // Каждая сессия сохраняется в своём strand, чтобы не пересекаться с запросами игроков
+            serialization::GameRepr game_repr;
+            serialization::ApplicationRepr app_repr;
+            game.RunInSessions([&game_repr, &app_repr, &app](model::GameSession& session) {
+                game_repr.AddSession(session);
+                app_repr.AddPlayers(app.GetTokensPlayersInSession(&session));
+            });
+            app_repr.SetCounterPlayerId(app.GetCounterPlayerId());
 
             std::ofstream ofs{temp_path, std::ios::out | std::ios::binary};
             if (!ofs.good()) {
@@ -1,13 +1,13 @@
 #include "state_serialization.h"
 
+#include <stdexcept>
+
 namespace serialization {
 
-    model::Dog DogRepr::Restore() const {
+    void DogRepr::Restore(model::GameSession& session) const {
         model::Dog::Id id{id_};
-        model::Dog dog(id, name_, max_speed_, bag_capacity_);
+        model::Dog& dog = session.RestoreDog(id, name_, max_speed_, bag_capacity_);
         dog.Restore(pos_, speed_, dir_, bag_, score_);
-
-        return dog;
     }
 
     app::Player PlayerRepr::Restore(model::Game& game) const {
@@ -15,10 +15,12 @@ namespace serialization {
         model::GameSession& session = game.GetSession(map_id);
 
         model::Dog::Id dog_id{dog_id_};
-        auto& dogs = session.GetDogs();
-        model::Dog& dog = dogs.at(dog_id);
+        model::Dog* dog = session.FindDog(dog_id);
+        if (dog == nullptr) {
+            throw std::out_of_range("Dog of restored player has not been found");
+        }
 
-        return app::Player(session, dog, id_, name_);
+        return app::Player(session, *dog, id_, name_);
     }
 
     uint64_t PlayerRepr::GetId() const {
@@ -29,11 +31,12 @@ namespace serialization {
         return std::pair<std::string, uint64_t>{token_, player_id_};
     }
 
-    std::vector<DogRepr> SessionRepr::GetDogsRepr(const std::unordered_map<model::Dog::Id, model::Dog, model::GameSession::DogIdHasher>& dogs) const {
+    std::vector<DogRepr> SessionRepr::GetDogsRepr(const model::GameSession& session) const {
         std::vector<DogRepr> res;
-        for(const auto& [dog_id, dog] : dogs) {
+        res.reserve(session.GetDogsCount());
+        session.ForEachDog([&res](const model::Dog& dog) {
             res.emplace_back(dog);
-        }
+        });
 
         return res;
     }
@@ -41,22 +44,19 @@ namespace serialization {
     void SessionRepr::Restore(model::Game& game) {
         model::Map::Id id {map_id_};
         model::GameSession& session = game.GetSession(id);
-        std::vector<model::Dog> dogs;
+        session.Restore(loot_in_map_, next_dog_id_);
 
         for(const auto& dog : dogs_) {
-            dogs.emplace_back(dog.Restore());
+            dog.Restore(session);
         }
-        session.Restore(dogs, loot_in_map_, next_dog_id_);
-    }
 
-    std::vector<SessionRepr> GameRepr::GetSessionsRepr(const std::unordered_map<model::Map::Id, model::GameSession, model::Game::MapIdHasher>& sessions) const {
-        std::vector<SessionRepr> sessions_res;
-
-        for(const auto& [map_id, session] : sessions) {
-            sessions_res.emplace_back(session);
-        }
+        session.PublishSnapshot();
+    }
 
-        return sessions_res;
+    void GameRepr::AddSession(const model::GameSession& session) {
+        SessionRepr session_repr(session);
+        std::lock_guard<std::mutex> lock(mtx_);
+        sessions_.emplace_back(std::move(session_repr));
     }
 
     void GameRepr::Restore(model::Game& game) {
@@ -65,13 +65,18 @@ namespace serialization {
         }
     }
 
-    void ApplicationRepr::Init(const std::unordered_map<app::Token, app::Player*>& tokens_to_player) {
+    void ApplicationRepr::AddPlayers(const std::vector<std::pair<app::Token, const app::Player*>>& tokens_to_player) {
+        std::lock_guard<std::mutex> lock(mtx_);
         for(const auto& [token, player_ptr] : tokens_to_player) {
             tokens_.emplace_back(token, *player_ptr);
             players_.emplace_back(*player_ptr);
         }
     }
 
+    void ApplicationRepr::SetCounterPlayerId(uint64_t next_player_id) {
+        next_player_id_ = next_player_id;
+    }
+
     void ApplicationRepr::Restore(model::Game& game, app::Application& app) {
         std::unordered_map<uint64_t, app::Player> players;
         std::unordered_map<app::Token, app::Player> token_to_player;
@@ -5,6 +5,7 @@
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/string.hpp>
 #include <cstdint>
+#include <mutex>
 
 #include "model.h"
 #include "application.h"
@@ -64,7 +65,7 @@ namespace serialization {
             ar & score_;
         }
 
-        model::Dog Restore() const;
+        void Restore(model::GameSession& session) const;
     private:
         uint64_t id_ = 0;
         std::string name_;
@@ -129,7 +130,7 @@ namespace serialization {
         SessionRepr() = default;
         explicit SessionRepr(const model::GameSession& session) 
             : map_id_{*session.GetMap()->GetId()}
-            , dogs_{GetDogsRepr(session.GetDogs())}
+            , dogs_{GetDogsRepr(session)}
             , loot_in_map_{session.GetLootInMap()}
             , next_dog_id_{session.GetCounterDogId()} {
         }
@@ -149,35 +150,29 @@ namespace serialization {
         std::vector<model::Loot> loot_in_map_;
         uint64_t next_dog_id_ = 0;
     private:
-        std::vector<DogRepr> GetDogsRepr(const std::unordered_map<model::Dog::Id, model::Dog, model::GameSession::DogIdHasher>& dogs) const;
+        std::vector<DogRepr> GetDogsRepr(const model::GameSession& session) const;
     };
 
     class GameRepr {
     public:
         GameRepr() = default;
-        explicit GameRepr(const model::Game& game) 
-            : sessions_{GetSessionsRepr(game.GetSessions())} {
-        }
 
         template<class Archive>
         void serialize(Archive &ar, [[maybe_unused]] const unsigned int version) {
             ar & sessions_;
         }
 
+        // Вызывается из strand сессии, поэтому добавление можно делать параллельно
+        void AddSession(const model::GameSession& session);
         void Restore(model::Game& game);
     private:
+        std::mutex mtx_;
         std::vector<SessionRepr> sessions_;
-    private:
-        std::vector<SessionRepr> GetSessionsRepr(const std::unordered_map<model::Map::Id, model::GameSession, model::Game::MapIdHasher>& sessions) const;
     };
 
     class ApplicationRepr {
     public:
         ApplicationRepr() = default;
-        explicit ApplicationRepr(const app::Application& app) 
-            : next_player_id_{app.GetCounterPlayerId()} {
-            Init(app.GetTokensPlayers());
-        }
 
         template<class Archive>
         void serialize(Archive &ar, [[maybe_unused]] const unsigned int version) {
@@ -186,13 +181,15 @@ namespace serialization {
             ar & next_player_id_;
         }
 
+        // Вызывается из strand сессии, поэтому добавление можно делать параллельно
+        void AddPlayers(const std::vector<std::pair<app::Token, const app::Player*>>& tokens_to_player);
+        void SetCounterPlayerId(uint64_t next_player_id);
         void Restore(model::Game& game, app::Application& app);
     private:
+        std::mutex mtx_;
         std::vector<PlayerRepr> players_;
         std::vector<TokenRepr> tokens_;
         uint64_t next_player_id_ = 0;
-    private:
-        void Init(const std::unordered_map<app::Token, app::Player*>& tokens_to_player);
     };
 
 } //namespace serialization
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "model.h"
+
+namespace {
+using namespace model;
+
+std::shared_ptr<Map> MakeMap() {
+    auto map = std::make_shared<Map>(Map::Id{"map"}, "Map", 1.0, 3, std::vector<int>{10});
+    map->AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 40));
+    map->AddRoad(Road(Road::VERTICAL, Point{0, 0}, 40));
+    map->BuildRoadIndex();
+    return map;
+}
+
+}  // namespace
+
+SCENARIO("Player action queue") {
+    GIVEN("a session with two dogs") {
+        loot_gen::LootGenerator loot_gen{std::chrono::milliseconds{1000}, 1.0, [] { return 0.0; }};
+        Game game(loot_gen, 1.0, 3, 60000, false);
+        game.AddMap(MakeMap());
+        auto& session = game.GetSession(Map::Id{"map"});
+        auto& first = session.AddDog("first");
+        auto& second = session.AddDog("second");
+
+        WHEN("an action is pushed") {
+            session.PushAction(MakeDogAction(*first.GetId(), "R"));
+
+            THEN("it is applied on the next tick, not immediately") {
+                CHECK(first.GetSpeed().h_speed == 0.0);
+                session.Tick(0);
+                CHECK(first.GetSpeed().h_speed == 1.0);
+                CHECK(first.GetDir() == Direction::EAST);
+            }
+        }
+
+        WHEN("several actions are pushed before a tick") {
+            session.PushAction(MakeDogAction(*first.GetId(), "R"));
+            session.PushAction(MakeDogAction(*second.GetId(), "D"));
+            session.PushAction(MakeDogAction(*first.GetId(), "U"));
+            session.Tick(0);
+
+            THEN("they are applied in the order they were pushed") {
+                CHECK(first.GetDir() == Direction::NORTH);
+                CHECK(first.GetSpeed().v_speed == -1.0);
+                CHECK(second.GetDir() == Direction::SOUTH);
+                CHECK(second.GetSpeed().v_speed == 1.0);
+            }
+        }
+
+        WHEN("the dog leaves before its action is applied") {
+            session.PushAction(MakeDogAction(*second.GetId(), "R"));
+            session.PushAction(MakeDogAction(*first.GetId(), "D"));
+            session.DeleteDog(second.GetId());
+
+            THEN("the action is skipped and the rest are applied") {
+                REQUIRE_NOTHROW(session.Tick(0));
+                CHECK(first.GetDir() == Direction::SOUTH);
+            }
+        }
+
+        WHEN("a producer keeps pushing while the session ticks") {
+            constexpr int ACTIONS = 200000;
+            std::atomic<bool> done = false;
+            std::thread producer{[&session, &first, &done] {
+                for (int i = 0; i < ACTIONS; ++i) {
+                    session.PushAction(MakeDogAction(*first.GetId(), i % 2 == 0 ? "L" : "R"));
+                }
+                session.PushAction(MakeDogAction(*first.GetId(), "U"));
+                done = true;
+            }};
+
+            // Тик забирает только команды, поставленные до его начала, поэтому завершается,
+            // даже если очередь всё время пополняется
+            int ticks = 0;
+            while (!done) {
+                session.Tick(0);
+                ++ticks;
+            }
+            producer.join();
+
+            THEN("every tick finishes and the last action wins after the queue is drained") {
+                CHECK(ticks > 0);
+                session.Tick(0);
+                CHECK(first.GetDir() == Direction::NORTH);
+
+                // Очередь пуста: следующий тик ничего не применяет
+                first.Action(MakeDogAction(*first.GetId(), "L"));
+                session.Tick(0);
+                CHECK(first.GetDir() == Direction::WEST);
+            }
+        }
+    }
+}
@@ -0,0 +1,359 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <type_traits>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/json.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "api_handler.h"
+#include "local_store.h"
+
+using namespace std::literals;
+
+namespace {
+    namespace fs = std::filesystem;
+    namespace net = boost::asio;
+    namespace http = http_handler::http;
+    namespace json = boost::json;
+
+    std::shared_ptr<model::Map> MakeMap(const std::string& id) {
+        auto map = std::make_shared<model::Map>(model::Map::Id{id}, id, 1.0, 3, std::vector<int>{10});
+        map->AddRoad(model::Road(model::Road::HORIZONTAL, model::Point{0, 0}, 40));
+        map->BuildRoadIndex();
+        return map;
+    }
+
+    struct Reply {
+        http::status status = http::status::unknown;
+        std::string body;
+        std::string etag;
+        // Разделяемое тело ответа, чтобы проверять, что строка взята из кэша
+        std::shared_ptr<const std::string> shared_body;
+    };
+
+    template <typename Response>
+    Reply MakeReply(const Response& response) {
+        Reply reply{.status = response.result()};
+        if (auto etag = response.find(http::field::etag); etag != response.end()) {
+            reply.etag = std::string(etag->value());
+        }
+        if constexpr (std::is_same_v<typename Response::body_type, http_handler::SharedStringBody>) {
+            reply.shared_body = response.body();
+            reply.body = response.body() ? *response.body() : ""s;
+        } else {
+            reply.body = response.body();
+        }
+        return reply;
+    }
+
+    // Временный каталог, удаляется последним, после закрытия хранилища
+    struct TempDir {
+        TempDir()
+            : path{fs::temp_directory_path() / ("api_handler_test_"s + std::to_string(std::rand()))} {
+            fs::create_directories(path);
+        }
+
+        ~TempDir() {
+            std::error_code ec;
+            fs::remove_all(path, ec);
+        }
+
+        fs::path path;
+    };
+
+    // Обработчик API с одной картой, локальным хранилищем рекордов во временном каталоге
+    // и потоком ввода-вывода для запросов, которые уходят в strand
+    class ApiFixture {
+    public:
+        ApiFixture()
+            : game_{loot_gen::LootGenerator{1000ms, 1.0, [] { return 0.0; }}, 1.0, 3, 60000, false}
+            , store_{dir_.path / "scores.log"}
+            , app_{store_.GetFactory(), postgres::ScoreWriterSettings{}, 1}
+            , work_{net::make_work_guard(ioc_)}
+            , io_thread_{[this] { ioc_.run(); }} {
+            game_.AddMap(MakeMap("map1"));
+            handler_.emplace(game_, app_, extra_data_, net::make_strand(ioc_), std::nullopt);
+        }
+
+        ~ApiFixture() {
+            work_.reset();
+            io_thread_.join();
+        }
+
+        // Запрос с телом JSON и, если передан токен, заголовком Authorization
+        static http_handler::StringRequest MakeRequest(http::verb verb, std::string_view target, std::string_view token = {}, std::string body = {}) {
+            http_handler::StringRequest req{verb, target, 11};
+            if (!token.empty()) {
+                req.set(http::field::authorization, "Bearer "s + std::string(token));
+            }
+            if (!body.empty()) {
+                req.set(http::field::content_type, http_handler::ContentType::APP_JSON);
+                req.body() = std::move(body);
+                req.prepare_payload();
+            }
+            return req;
+        }
+
+        Reply Get(std::string_view target) {
+            return Send(MakeRequest(http::verb::get, target));
+        }
+
+        struct Joined {
+            std::string token;
+            std::string player_id;
+        };
+
+        // Входит в игру на карте map1 и возвращает токен и id игрока
+        Joined Join(std::string_view name) {
+            auto reply = Send(MakeRequest(http::verb::post, "/api/v1/game/join"sv, {},
+                                          json::serialize(json::object{{"userName", name}, {"mapId", "map1"}})));
+            REQUIRE(reply.status == http::status::ok);
+            const auto answer = json::parse(reply.body).as_object();
+            return {std::string(answer.at("authToken").as_string()), std::to_string(answer.at("playerId").to_number<uint64_t>())};
+        }
+
+        Reply Move(std::string_view token, std::string_view direction) {
+            return Send(MakeRequest(http::verb::post, "/api/v1/game/player/action"sv, token,
+                                    json::serialize(json::object{{"move", direction}})));
+        }
+
+        Reply Tick(int64_t time_delta) {
+            return Send(MakeRequest(http::verb::post, "/api/v1/game/tick"sv, {},
+                                    json::serialize(json::object{{"timeDelta", time_delta}})));
+        }
+
+        Reply Send(http_handler::StringRequest req) {
+            std::promise<Reply> reply;
+            auto future = reply.get_future();
+            (*handler_)(std::move(req), [&reply](auto&& response) {
+                reply.set_value(MakeReply(response));
+            });
+            return future.get();
+        }
+    private:
+        TempDir dir_;
+        model::Game game_;
+        extra_data::ExtraData extra_data_;
+        postgres::LocalScoreStore store_;
+        app::Application app_;
+        net::io_context ioc_;
+        net::executor_work_guard<net::io_context::executor_type> work_;
+        std::thread io_thread_;
+        std::optional<http_handler::ApiHandler> handler_;
+    };
+
+    std::string ErrorCode(const Reply& reply) {
+        return std::string(json::parse(reply.body).as_object().at("code").as_string());
+    }
+}
+
+SCENARIO("Records paging parameters") {
+    GIVEN("an API handler with an empty leaderboard") {
+        ApiFixture api;
+
+        THEN("values within the int range are accepted") {
+            auto reply = api.Get("/api/v1/game/records?start=2147483647&maxItems=100"sv);
+            CHECK(reply.status == http::status::ok);
+            CHECK(reply.body == "[]"s);
+        }
+
+        THEN("values above INT_MAX are rejected instead of wrapping around") {
+            for (auto target : {"/api/v1/game/records?maxItems=4294967297"sv,
+                                "/api/v1/game/records?start=2147483648"sv,
+                                "/api/v1/game/records?start=9223372036854775807"sv}) {
+                auto reply = api.Get(target);
+                CHECK(reply.status == http::status::bad_request);
+                CHECK(ErrorCode(reply) == "invalidArgument"s);
+            }
+        }
+
+        THEN("negative and malformed values are rejected") {
+            for (auto target : {"/api/v1/game/records?start=-1"sv,
+                                "/api/v1/game/records?maxItems=-5"sv,
+                                "/api/v1/game/records?maxItems=10abc"sv}) {
+                auto reply = api.Get(target);
+                CHECK(reply.status == http::status::bad_request);
+                CHECK(ErrorCode(reply) == "invalidArgument"s);
+            }
+        }
+    }
+}
+
+SCENARIO("Conditional requests with ETag") {
+    GIVEN("an API handler with one joined player") {
+        ApiFixture api;
+        const auto token = api.Join("player"sv).token;
+
+        const auto get = [&api, &token](std::string_view target, std::string_view if_none_match = {}) {
+            auto req = ApiFixture::MakeRequest(http::verb::get, target, target.starts_with("/api/v1/game"sv) ? token : ""sv);
+            if (!if_none_match.empty()) {
+                req.set(http::field::if_none_match, if_none_match);
+            }
+            return api.Send(std::move(req));
+        };
+
+        THEN("the map list answers 304 without a body to a matching If-None-Match") {
+            auto first = get("/api/v1/maps"sv);
+            REQUIRE(first.status == http::status::ok);
+            REQUIRE_FALSE(first.etag.empty());
+
+            auto cached = get("/api/v1/maps"sv, first.etag);
+            CHECK(cached.status == http::status::not_modified);
+            CHECK(cached.body.empty());
+            CHECK(cached.etag == first.etag);
+
+            CHECK(get("/api/v1/maps"sv, "\"other\""sv).status == http::status::ok);
+        }
+
+        THEN("the state answers 304 while the snapshot version is the same") {
+            auto first = get("/api/v1/game/state"sv);
+            REQUIRE(first.status == http::status::ok);
+            REQUIRE_FALSE(first.etag.empty());
+
+            auto cached = get("/api/v1/game/state"sv, first.etag);
+            CHECK(cached.status == http::status::not_modified);
+            CHECK(cached.body.empty());
+            CHECK(cached.etag == first.etag);
+        }
+
+        WHEN("the dog moves and the snapshot version changes") {
+            auto before = get("/api/v1/game/state"sv);
+            REQUIRE(api.Move(token, "R"sv).status == http::status::ok);
+            REQUIRE(api.Tick(100).status == http::status::ok);
+
+            THEN("the state gets a new ETag and the old one no longer matches") {
+                auto after = get("/api/v1/game/state"sv, before.etag);
+                CHECK(after.status == http::status::ok);
+                CHECK_FALSE(after.etag.empty());
+                CHECK(after.etag != before.etag);
+                CHECK(after.body != before.body);
+            }
+        }
+
+        THEN("a delta request has no ETag") {
+            auto delta = get("/api/v1/game/state?since=0"sv);
+            CHECK(delta.status == http::status::ok);
+            CHECK(delta.etag.empty());
+        }
+    }
+}
+
+SCENARIO("Serialized state cache") {
+    GIVEN("an API handler with one joined player") {
+        ApiFixture api;
+        const auto token = api.Join("player"sv).token;
+
+        const auto get_state = [&api, &token](bool binary = false) {
+            auto req = ApiFixture::MakeRequest(http::verb::get, "/api/v1/game/state"sv, token);
+            if (binary) {
+                req.set(http::field::accept, http_handler::ContentType::APP_BIN);
+            }
+            return api.Send(std::move(req));
+        };
+
+        THEN("requests within one snapshot version share the serialized body") {
+            auto first = get_state();
+            auto second = get_state();
+            REQUIRE(first.shared_body != nullptr);
+            CHECK(first.shared_body == second.shared_body);
+
+            // JSON и бинарное представление лежат в разных ячейках и не вытесняют друг друга
+            auto binary = get_state(true);
+            CHECK(binary.shared_body != first.shared_body);
+            CHECK(get_state(true).shared_body == binary.shared_body);
+            CHECK(get_state().shared_body == first.shared_body);
+        }
+
+        THEN("an idle tick keeps the version and the cached body") {
+            auto before = get_state();
+            REQUIRE(api.Tick(100).status == http::status::ok);
+            CHECK(get_state().shared_body == before.shared_body);
+        }
+
+        THEN("a tick that moves the dog invalidates the cached body") {
+            auto before = get_state();
+            REQUIRE(api.Move(token, "R"sv).status == http::status::ok);
+            REQUIRE(api.Tick(100).status == http::status::ok);
+
+            auto after = get_state();
+            CHECK(after.shared_body != before.shared_body);
+            CHECK(after.body != before.body);
+            CHECK(get_state().shared_body == after.shared_body);
+        }
+
+        THEN("a new player invalidates the cached body") {
+            auto before = get_state();
+            api.Join("second"sv);
+            CHECK(get_state().shared_body != before.shared_body);
+        }
+    }
+}
+
+SCENARIO("Joining through the session strand") {
+    GIVEN("an API handler") {
+        ApiFixture api;
+
+        const auto state_players = [&api](const std::string& token) {
+            auto reply = api.Send(ApiFixture::MakeRequest(http::verb::get, "/api/v1/game/state"sv, token));
+            REQUIRE(reply.status == http::status::ok);
+            return json::parse(reply.body).as_object().at("players").as_object();
+        };
+
+        THEN("the joined player is in the state right after the join reply") {
+            auto first = api.Join("first"sv);
+            CHECK(state_players(first.token).contains(first.player_id));
+
+            auto second = api.Join("second"sv);
+            const auto players = state_players(first.token);
+            CHECK(players.size() == 2);
+            CHECK(players.contains(first.player_id));
+            CHECK(players.contains(second.player_id));
+        }
+
+        THEN("players joining from several threads each see themselves in the next state") {
+            constexpr int CLIENTS = 4;
+            constexpr int JOINS = 10;
+            std::vector<std::thread> clients;
+            std::vector<int> seen(CLIENTS, 0);
+            for (int client = 0; client < CLIENTS; ++client) {
+                // Макросы Catch2 не потокобезопасны, поэтому в потоках только считаем совпадения
+                clients.emplace_back([&api, &seen, client] {
+                    for (int i = 0; i < JOINS; ++i) {
+                        const auto name = "player"s + std::to_string(client * JOINS + i);
+                        auto join = api.Send(ApiFixture::MakeRequest(http::verb::post, "/api/v1/game/join"sv, {},
+                                                                     json::serialize(json::object{{"userName", name}, {"mapId", "map1"}})));
+                        if (join.status != http::status::ok) {
+                            continue;
+                        }
+                        const auto answer = json::parse(join.body).as_object();
+                        const auto token = std::string(answer.at("authToken").as_string());
+                        const auto player_id = std::to_string(answer.at("playerId").to_number<uint64_t>());
+
+                        auto state = api.Send(ApiFixture::MakeRequest(http::verb::get, "/api/v1/game/state"sv, token));
+                        if (state.status == http::status::ok && json::parse(state.body).as_object().at("players").as_object().contains(player_id)) {
+                            ++seen[client];
+                        }
+                    }
+                });
+            }
+            for (auto& client : clients) {
+                client.join();
+            }
+
+            for (int count : seen) {
+                CHECK(count == JOINS);
+            }
+            CHECK(state_players(api.Join("last"sv).token).size() == CLIENTS * JOINS + 1);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "application.h"
+#include "local_store.h"
+
+using namespace std::literals;
+
+namespace {
+    namespace fs = std::filesystem;
+
+    std::shared_ptr<model::Map> MakeMap(const std::string& id) {
+        auto map = std::make_shared<model::Map>(model::Map::Id{id}, id, 1.0, 3, std::vector<int>{10});
+        map->AddRoad(model::Road(model::Road::HORIZONTAL, model::Point{0, 0}, 40));
+        map->BuildRoadIndex();
+        return map;
+    }
+
+    // Журнал рекордов во временном каталоге, удаляется вместе с каталогом
+    struct TempLog {
+        TempLog()
+            : dir{fs::temp_directory_path() / ("application_test_"s + std::to_string(std::rand()))}
+            , path{dir / "scores.log"} {
+            fs::create_directories(dir);
+        }
+
+        ~TempLog() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+
+        fs::path dir;
+        fs::path path;
+    };
+
+    app::TokenKey Key(const app::Token& token) {
+        return *app::TokenKey::Parse(token);
+    }
+}
+
+SCENARIO("Token lookups through the published index") {
+    GIVEN("players joined to two sessions") {
+        loot_gen::LootGenerator loot_gen{std::chrono::milliseconds{1000}, 0.0, [] { return 0.0; }};
+        model::Game game(loot_gen, 1.0, 3, 60000, false);
+        game.AddMap(MakeMap("first"));
+        game.AddMap(MakeMap("second"));
+        auto& first = game.GetSession(model::Map::Id{"first"});
+        auto& second = game.GetSession(model::Map::Id{"second"});
+
+        TempLog log;
+        postgres::LocalScoreStore store{log.path};
+        app::Application app{store.GetFactory(), postgres::ScoreWriterSettings{}, 0};
+
+        // Игроков больше, чем шардов индекса, чтобы в каждом шарде было несколько токенов
+        std::vector<app::Token> tokens;
+        std::vector<model::Dog*> dogs;
+        for (int i = 0; i < 200; ++i) {
+            auto& session = i % 2 == 0 ? first : second;
+            auto& dog = session.AddDog("dog"s + std::to_string(i));
+            dogs.push_back(&dog);
+            tokens.push_back(app.AddPlayer(session, dog).first);
+        }
+
+        THEN("every token resolves to its session and player list") {
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                auto* expected = i % 2 == 0 ? &first : &second;
+                CHECK(app.FindSessionByToken(Key(tokens[i])) == expected);
+
+                auto view = app.FindSessionViewByToken(Key(tokens[i]));
+                REQUIRE(view.has_value());
+                CHECK(view->session == expected);
+                CHECK(view->players->size() == 100);
+                CHECK(view->players->Find(dogs[i]->GetId()) != nullptr);
+            }
+            CHECK_FALSE(app.FindSessionViewByToken(app::TokenKey{.high = 1, .low = 2}).has_value());
+        }
+
+        THEN("an action pushed by token is applied on the next tick") {
+            REQUIRE(app.PushPlayerAction(Key(tokens[0]), "R"sv));
+            first.Tick(0);
+            CHECK(dogs[0]->GetSpeed().h_speed == 1.0);
+            CHECK_FALSE(app.PushPlayerAction(app::TokenKey{.high = 1, .low = 2}, "R"sv));
+        }
+
+        WHEN("a player leaves the game") {
+            const auto dog_id = dogs[2]->GetId();
+            app.ExitPlayer({DTO::ExitPlayer{.dog_id = static_cast<int64_t>(*dog_id), .map_id = "first"s}});
+
+            THEN("the token no longer resolves and the player is listed as departed") {
+                CHECK(app.FindSessionByToken(Key(tokens[2])) == nullptr);
+                CHECK_FALSE(app.FindSessionViewByToken(Key(tokens[2])).has_value());
+                CHECK_FALSE(app.PushPlayerAction(Key(tokens[2]), "L"sv));
+
+                auto view = app.FindSessionViewByToken(Key(tokens[0]));
+                REQUIRE(view.has_value());
+                CHECK(view->players->Find(dog_id) == nullptr);
+                CHECK(view->departed->Find(dog_id) != nullptr);
+                CHECK(app.GetSessionView(&first).players->size() == 99);
+            }
+
+            THEN("the other tokens still resolve") {
+                for (size_t i = 0; i < tokens.size(); ++i) {
+                    if (i != 2) {
+                        CHECK(app.FindSessionByToken(Key(tokens[i])) != nullptr);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "async_log.h"
+#include "log_record.h"
+
+using namespace std::literals;
+using namespace logger;
+
+namespace {
+    // 2024-01-02T03:04:05.000006 UTC
+    const auto TIMESTAMP = std::chrono::system_clock::time_point{std::chrono::microseconds{1704164645000006}};
+
+    size_t CountLines(std::string_view text, std::string_view needle) {
+        size_t count = 0;
+        for (auto pos = text.find(needle); pos != std::string_view::npos; pos = text.find(needle, pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+}
+
+SCENARIO("Log record builder") {
+    GIVEN("a record with data of different types") {
+        RecordBuilder record{TIMESTAMP, "request received"sv};
+        record.Add("ip"sv, "127.0.0.1"s);
+        record.Add("URI"sv, "/a\"b\\c\n"sv);
+        record.Add("code"sv, 200);
+        record.Add("ok"sv, true);
+
+        THEN("it is serialized as one JSON line with escaped strings") {
+            CHECK(record.Finish() == "{\"timestamp\":\"2024-01-02T03:04:05.000006\",\"message\":\"request received\","
+                                     "\"data\":{\"ip\":\"127.0.0.1\",\"URI\":\"/a\\\"b\\\\c\\n\",\"code\":200,\"ok\":true}}\n"sv);
+        }
+    }
+
+    GIVEN("a value longer than the record") {
+        RecordBuilder record{TIMESTAMP, "error"sv};
+        record.Add("text"sv, std::string(RecordBuilder::MAX_SIZE * 2, 'x'));
+        record.Add("code"sv, 1);
+        auto line = record.Finish();
+
+        THEN("the value is cut, later fields are dropped and the record stays valid") {
+            CHECK(line.size() <= RecordBuilder::MAX_SIZE);
+            CHECK(line.ends_with("x\",\"truncated\":true}}\n"sv));
+            CHECK(line.find("\"code\""sv) == std::string_view::npos);
+        }
+    }
+}
+
+SCENARIO("Asynchronous log backend") {
+    GIVEN("a backend writing to a string") {
+        std::mutex mtx;
+        std::string output;
+        size_t batches = 0;
+        auto sink = [&](std::string_view batch) {
+            std::lock_guard lock{mtx};
+            output.append(batch);
+            ++batches;
+        };
+
+        WHEN("several threads log with the blocking policy") {
+            constexpr int threads_count = 4;
+            constexpr int records_per_thread = 5000;
+            {
+                AsyncLogBackend backend{sink, AsyncLogSettings{.ring_size = 4096, .overflow = OverflowPolicy::BLOCK}};
+                std::vector<std::thread> threads;
+                for (int t = 0; t < threads_count; ++t) {
+                    threads.emplace_back([&backend] {
+                        for (int i = 0; i < records_per_thread; ++i) {
+                            backend.Push("record\n"sv);
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                backend.Stop();
+                CHECK(backend.GetDropped() == 0);
+            }
+
+            THEN("every record is written, in batches") {
+                CHECK(CountLines(output, "record\n"sv) == threads_count * records_per_thread);
+                CHECK(batches < threads_count * records_per_thread);
+            }
+        }
+
+        WHEN("the ring overflows with the drop policy") {
+            uint64_t dropped = 0;
+            {
+                // Фоновый поток не успеет разобрать 10000 записей при буфере на 2 КБ
+                AsyncLogBackend backend{sink, AsyncLogSettings{.ring_size = 2048, .overflow = OverflowPolicy::DROP,
+                                                               .flush_interval = std::chrono::milliseconds{1000}}};
+                for (int i = 0; i < 10000; ++i) {
+                    backend.Push("record\n"sv);
+                }
+                dropped = backend.GetDropped();
+            }
+
+            THEN("records are dropped without blocking and the loss is reported") {
+                CHECK(dropped > 0);
+                CHECK(CountLines(output, "record\n"sv) + dropped == 10000);
+                CHECK(output.find("log records dropped"sv) != std::string::npos);
+            }
+        }
+    }
+}
@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "binary_encoding.h"
+#include "binary_writer.h"
+
+using namespace std::literals;
+
+namespace {
+    using app::Application;
+    using http_handler::binary_encoding::MessageKind;
+
+    struct DecodedDog {
+        model::Position pos;
+        model::Speed speed;
+        model::Direction dir = model::Direction::NORTH;
+        int score = 0;
+        std::vector<std::pair<int, size_t>> bag;
+
+        bool operator==(const DecodedDog& other) const {
+            return pos == other.pos && speed.h_speed == other.speed.h_speed && speed.v_speed == other.speed.v_speed
+                && dir == other.dir && score == other.score && bag == other.bag;
+        }
+    };
+
+    struct DecodedLoot {
+        size_t type = 0;
+        model::Position pos;
+
+        bool operator==(const DecodedLoot& other) const {
+            return type == other.type && pos == other.pos;
+        }
+    };
+
+    // Сообщение STATE или STATE_DELTA. У полного состояния списки удалённых пусты
+    struct DecodedState {
+        MessageKind kind = MessageKind::STATE;
+        uint64_t tick = 0;
+        std::map<uint64_t, DecodedDog> players;
+        std::vector<uint64_t> removed_players;
+        std::map<int, DecodedLoot> loot;
+        std::vector<int> removed_loot;
+    };
+
+    DecodedDog ReadDog(binary::Reader& reader) {
+        DecodedDog dog;
+        dog.pos.x = reader.ReadQuantized();
+        dog.pos.y = reader.ReadQuantized();
+        dog.speed.h_speed = reader.ReadQuantized();
+        dog.speed.v_speed = reader.ReadQuantized();
+        dog.dir = static_cast<model::Direction>(reader.ReadByte());
+        dog.score = static_cast<int>(reader.ReadVarint());
+        for (auto size = reader.ReadVarint(); size > 0; --size) {
+            const auto id = static_cast<int>(reader.ReadVarint());
+            dog.bag.emplace_back(id, static_cast<size_t>(reader.ReadVarint()));
+        }
+        return dog;
+    }
+
+    void ReadLoot(binary::Reader& reader, std::map<int, DecodedLoot>& loot) {
+        for (auto size = reader.ReadVarint(); size > 0; --size) {
+            const auto id = static_cast<int>(reader.ReadVarint());
+            DecodedLoot item;
+            item.type = reader.ReadVarint();
+            item.pos.x = reader.ReadQuantized();
+            item.pos.y = reader.ReadQuantized();
+            loot.emplace(id, item);
+        }
+    }
+
+    DecodedState Decode(const std::string& data) {
+        binary::Reader reader{data};
+        DecodedState state;
+        state.kind = static_cast<MessageKind>(reader.ReadByte());
+        state.tick = reader.ReadVarint();
+
+        for (auto size = reader.ReadVarint(); size > 0; --size) {
+            const auto id = reader.ReadVarint();
+            state.players.emplace(id, ReadDog(reader));
+        }
+
+        if (state.kind == MessageKind::STATE_DELTA) {
+            for (auto size = reader.ReadVarint(); size > 0; --size) {
+                state.removed_players.push_back(reader.ReadVarint());
+            }
+            ReadLoot(reader, state.loot);
+            for (auto size = reader.ReadVarint(); size > 0; --size) {
+                state.removed_loot.push_back(static_cast<int>(reader.ReadVarint()));
+            }
+        } else {
+            ReadLoot(reader, state.loot);
+        }
+
+        REQUIRE(reader.AtEnd());
+        return state;
+    }
+
+    DecodedDog Expected(const model::DogSnapshot& dog) {
+        DecodedDog expected{.pos = dog.pos, .speed = dog.speed, .dir = dog.dir, .score = dog.score};
+        for (const auto& loot : dog.bag) {
+            expected.bag.emplace_back(loot.id, loot.type);
+        }
+        return expected;
+    }
+
+    std::shared_ptr<const model::SessionChanges> MakeChanges(uint64_t version, std::vector<uint64_t> changed, std::vector<uint64_t> removed,
+                                                             std::vector<int> added_loot, std::vector<int> removed_loot) {
+        auto changes = std::make_shared<model::SessionChanges>();
+        changes->version = version;
+        for (auto id : changed) {
+            changes->changed_dogs.push_back(model::Dog::Id{id});
+        }
+        for (auto id : removed) {
+            changes->removed_dogs.push_back(model::Dog::Id{id});
+        }
+        changes->added_loot = std::move(added_loot);
+        changes->removed_loot = std::move(removed_loot);
+        return changes;
+    }
+
+    std::shared_ptr<const Application::SessionPlayers> MakePlayers(const std::vector<std::pair<app::Player::Id, uint64_t>>& players) {
+        auto list = std::make_shared<const Application::SessionPlayers>();
+        for (const auto& [player_id, dog_id] : players) {
+            list = list->Insert({player_id, model::Dog::Id{dog_id}, "player"s + std::to_string(player_id)});
+        }
+        return list;
+    }
+
+    /*
+     * Версия 8: игрок 10 (собака 1) бежит с двумя предметами в рюкзаке, игрок 30 (собака 3) только вошёл.
+     * В версии 8 ушёл игрок 20 (собака 2) и подобран лут 5, появился лут 7
+     */
+    Application::SessionView MakeView() {
+        auto snapshot = std::make_shared<model::SessionSnapshot>();
+        snapshot->version = 8;
+        snapshot->dogs = {
+            model::DogSnapshot{
+                .id = model::Dog::Id{1},
+                .pos = {12.345, -0.5},
+                .speed = {-1.5, 0.0},
+                .dir = model::Direction::WEST,
+                .bag = {model::Loot{.id = 3, .type = 1}, model::Loot{.id = 4, .type = 0}},
+                .score = 300
+            },
+            model::DogSnapshot{.id = model::Dog::Id{3}, .pos = {0.0, 40.0}, .dir = model::Direction::SOUTH}
+        };
+        snapshot->loot_in_map = {
+            model::Loot{.id = 6, .type = 2, .pos = {1.0, 2.5}},
+            model::Loot{.id = 7, .type = 0, .pos = {-3.25, 0.001}}
+        };
+        snapshot->history = {
+            MakeChanges(7, {1}, {}, {6}, {}),
+            MakeChanges(8, {1, 3}, {2}, {7}, {5})
+        };
+
+        return Application::SessionView{
+            .snapshot = std::move(snapshot),
+            .players = MakePlayers({{10, 1}, {30, 3}}),
+            .departed = MakePlayers({{20, 2}})
+        };
+    }
+}
+
+SCENARIO("Binary state encoding round trip") {
+    GIVEN("a session view with players, loot and a departed player") {
+        const auto view = MakeView();
+        const auto& snapshot = *view.snapshot;
+
+        THEN("the full state decodes to the snapshot") {
+            const auto state = Decode(http_handler::binary_encoding::EncodeState(view));
+            CHECK(state.kind == MessageKind::STATE);
+            CHECK(state.tick == 8);
+            REQUIRE(state.players.size() == 2);
+            CHECK(state.players.at(10) == Expected(snapshot.dogs[0]));
+            CHECK(state.players.at(30) == Expected(snapshot.dogs[1]));
+            REQUIRE(state.loot.size() == 2);
+            CHECK(state.loot.at(6) == DecodedLoot{.type = 2, .pos = {1.0, 2.5}});
+            CHECK(state.loot.at(7) == DecodedLoot{.type = 0, .pos = {-3.25, 0.001}});
+        }
+
+        THEN("the delta decodes to changed and removed players and loot") {
+            const auto delta = Decode(http_handler::binary_encoding::EncodeStateDelta(view, 7));
+            CHECK(delta.kind == MessageKind::STATE_DELTA);
+            CHECK(delta.tick == 8);
+            REQUIRE(delta.players.size() == 2);
+            CHECK(delta.players.at(10) == Expected(snapshot.dogs[0]));
+            CHECK(delta.players.at(30) == Expected(snapshot.dogs[1]));
+            CHECK(delta.removed_players == std::vector<uint64_t>{20});
+            REQUIRE(delta.loot.size() == 1);
+            CHECK(delta.loot.at(7) == DecodedLoot{.type = 0, .pos = {-3.25, 0.001}});
+            CHECK(delta.removed_loot == std::vector<int>{5});
+        }
+
+        THEN("a delta merged over two versions keeps the loot that is still on the map") {
+            const auto delta = Decode(http_handler::binary_encoding::EncodeStateDelta(view, 6));
+            CHECK(delta.kind == MessageKind::STATE_DELTA);
+            REQUIRE(delta.loot.size() == 2);
+            CHECK(delta.loot.count(6) == 1);
+            CHECK(delta.removed_loot == std::vector<int>{5});
+        }
+
+        THEN("a delta from a lost version falls back to the full state") {
+            const auto state = Decode(http_handler::binary_encoding::EncodeStateDelta(view, 2));
+            CHECK(state.kind == MessageKind::STATE);
+            CHECK(state.players.size() == 2);
+            CHECK(state.loot.size() == 2);
+        }
+    }
+}
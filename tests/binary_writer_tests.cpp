@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "binary_writer.h"
+
+SCENARIO("Binary writer primitives") {
+    GIVEN("a writer") {
+        binary::Writer writer;
+
+        WHEN("small and large varints are written") {
+            writer.WriteVarint(0);
+            writer.WriteVarint(127);
+            writer.WriteVarint(128);
+            writer.WriteVarint(std::numeric_limits<uint64_t>::max());
+            auto data = writer.Release();
+
+            THEN("values below 128 take one byte and all of them round-trip") {
+                CHECK(data.size() == 1 + 1 + 2 + 10);
+
+                binary::Reader reader{data};
+                CHECK(reader.ReadVarint() == 0);
+                CHECK(reader.ReadVarint() == 127);
+                CHECK(reader.ReadVarint() == 128);
+                CHECK(reader.ReadVarint() == std::numeric_limits<uint64_t>::max());
+                CHECK(reader.AtEnd());
+            }
+        }
+
+        WHEN("signed values, quantized positions and strings are written") {
+            writer.WriteSigned(-1);
+            writer.WriteSigned(std::numeric_limits<int64_t>::min());
+            writer.WriteQuantized(-12.3456);
+            writer.WriteQuantized(0.0004);
+            writer.WriteString("Pluto");
+            auto data = writer.Release();
+
+            THEN("small negatives stay short and positions keep thousandths") {
+                CHECK(binary::Writer::ZigZag(-1) == 1);
+                CHECK(binary::Writer::ZigZag(1) == 2);
+
+                binary::Reader reader{data};
+                CHECK(reader.ReadSigned() == -1);
+                CHECK(reader.ReadSigned() == std::numeric_limits<int64_t>::min());
+                CHECK(reader.ReadQuantized() == -12.346);
+                CHECK(reader.ReadQuantized() == 0.0);
+                CHECK(reader.ReadString() == "Pluto");
+                CHECK(reader.AtEnd());
+            }
+        }
+
+        WHEN("the data is truncated") {
+            writer.WriteString("Pluto");
+            auto data = writer.Release();
+            data.pop_back();
+
+            THEN("the reader throws instead of reading past the end") {
+                binary::Reader reader{data};
+                CHECK_THROWS_AS(reader.ReadString(), std::out_of_range);
+            }
+        }
+    }
+}
@@ -174,4 +174,79 @@ SCENARIO("Collision detection") {
             CHECK(events.empty());
         }
     }
-}
\ No newline at end of file
+}
+
+#include <random>
+
+SCENARIO("Broadphase collision detection") {
+    WHEN("multiple items on a way of gatherer") {
+        std::vector<Item> items {
+            {P(9, 0.27), .1},
+            {P(8, 0.24), .1},
+            {P(7, 0.21), .1},
+            {P(6, 0.18), .1},
+            {P(5, 0.15), .1},
+            {P(4, 0.12), .1},
+            {P(3, 0.09), .1},
+            {P(2, 0.06), .1},
+            {P(1, 0.03), .1},
+            {P(0, 0.0), .1},
+            {P(-1, 0), .1},
+        };
+        std::vector<Gatherer> gatherers {
+            {P(0, 0), P(10, 0), 0.1}
+        };
+        VectorItemGathererProvider provider{items, gatherers};
+        THEN("Gathered items in right order") {
+            auto events = collision_detector::FindGatherEventsBroadphase(provider);
+            CHECK_THAT(
+                events,
+                Catch::Matchers::RangeEquals(collision_detector::FindGatherEvents(provider), CompareEvents()));
+        }
+    }
+    WHEN("Gatherers stay put") {
+        std::vector<Item> items {
+            {P(0, 0), 10.}
+        };
+        std::vector<Gatherer> gatherers {
+            {P(-5, 0), P(-5, 0), 1.},
+            {P(0, 0), P(0, 0), 1.},
+        };
+        VectorItemGathererProvider provider{items, gatherers};
+        THEN("No events detected") {
+            CHECK(collision_detector::FindGatherEventsBroadphase(provider).empty());
+        }
+    }
+    WHEN("many gatherers and items are scattered over the map") {
+        std::mt19937 gen{2024};
+        std::uniform_real_distribution<double> coord{-50., 50.};
+        std::uniform_real_distribution<double> step{-3., 3.};
+        std::uniform_real_distribution<double> width{0., 1.};
+
+        std::vector<Item> items;
+        for (int i = 0; i < 2000; ++i) {
+            items.push_back({P(coord(gen), coord(gen)), i % 10 == 0 ? width(gen) : 0.});
+        }
+
+        std::vector<Gatherer> gatherers;
+        for (int i = 0; i < 500; ++i) {
+            const Point start = P(coord(gen), coord(gen));
+            // Собаки двигаются вдоль осей, часть перемещений - диагональные и длинные
+            Point end = i % 2 == 0 ? P(start.x + step(gen), start.y) : P(start.x, start.y + step(gen));
+            if (i % 50 == 0) {
+                end = P(coord(gen), coord(gen));
+            }
+            gatherers.push_back({start, end, 0.6});
+        }
+        VectorItemGathererProvider provider{items, gatherers};
+
+        THEN("Broadphase finds the same events as the reference implementation") {
+            auto expected = collision_detector::FindGatherEvents(provider);
+            collision_detector::SortGatherEvents(expected);
+            auto events = collision_detector::FindGatherEventsBroadphase(provider);
+
+            CHECK_FALSE(events.empty());
+            CHECK_THAT(events, Catch::Matchers::RangeEquals(expected, CompareEvents()));
+        }
+    }
+}
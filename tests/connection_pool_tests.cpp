@@ -0,0 +1,62 @@
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "connection_pool.h"
+
+using namespace std::literals;
+
+namespace {
+    // Пул не обращается к соединению, поэтому вместо pqxx::connection достаточно заглушки
+    struct FakeConnection {
+        int id = 0;
+    };
+
+    using FakePool = postgres::BasicConnectionPool<FakeConnection>;
+}
+
+SCENARIO("Connection pool with a single connection") {
+    GIVEN("a pool of size 1") {
+        int created = 0;
+        FakePool pool{1, [&created] {
+            return std::make_shared<FakeConnection>(FakeConnection{++created});
+        }};
+
+        THEN("the connection is created once, returned on release and handed out again") {
+            const FakeConnection* first = nullptr;
+            {
+                auto conn = pool.GetConnection(100ms);
+                first = &*conn;
+                CHECK(conn->id == 1);
+            }
+
+            auto again = pool.GetConnection(100ms);
+            CHECK(&*again == first);
+            CHECK(created == 1);
+        }
+
+        THEN("a second checkout times out while the connection is held") {
+            auto conn = pool.GetConnection(100ms);
+            CHECK_THROWS_AS(pool.GetConnection(10ms), std::runtime_error);
+        }
+
+        THEN("a waiting checkout gets the connection as soon as it is returned") {
+            auto conn = std::make_optional(pool.GetConnection(100ms));
+            const FakeConnection* held = &**conn;
+
+            auto waiter = std::async(std::launch::async, [&pool] {
+                auto conn = pool.GetConnection(5s);
+                return &*conn;
+            });
+            CHECK(waiter.wait_for(50ms) == std::future_status::timeout);
+
+            conn.reset();
+            CHECK(waiter.get() == held);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dog_store.h"
+
+namespace {
+using model::Dog;
+using model::DogStore;
+using model::Position;
+using model::Speed;
+
+std::vector<uint64_t> CollectIdle(DogStore& store, int64_t idle_limit) {
+    std::vector<Dog::Id> ids;
+    store.CollectIdle(idle_limit, ids);
+
+    std::vector<uint64_t> result;
+    for (const auto& id : ids) {
+        result.push_back(*id);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("Dog store timers") {
+    constexpr int64_t IDLE_LIMIT = 1000;
+
+    GIVEN("a store with two standing dogs") {
+        DogStore store;
+        store.Add(Dog::Id{1}, Position{});
+        store.Add(Dog::Id{2}, Position{});
+
+        WHEN("time passes below the idle limit") {
+            store.AdvanceTime(999);
+
+            THEN("nobody retires and play time is counted from the join") {
+                CHECK(CollectIdle(store, IDLE_LIMIT).empty());
+                CHECK(store.GetIdleTime(store.GetSlot(Dog::Id{1})) == 999);
+                CHECK(store.GetPlayTime(store.GetSlot(Dog::Id{2})) == 999);
+            }
+        }
+
+        WHEN("one dog moves and the limit is reached") {
+            store.SetSpeed(store.GetSlot(Dog::Id{1}), Speed{1, 0});
+            store.AdvanceTime(1000);
+
+            THEN("only the standing dog retires, and only once") {
+                CHECK(CollectIdle(store, IDLE_LIMIT) == std::vector<uint64_t>{2});
+                CHECK(CollectIdle(store, IDLE_LIMIT).empty());
+                CHECK(store.GetIdleTime(store.GetSlot(Dog::Id{1})) == 0);
+            }
+        }
+
+        WHEN("a dog stops later than the other") {
+            store.SetSpeed(store.GetSlot(Dog::Id{1}), Speed{1, 0});
+            store.AdvanceTime(500);
+            store.SetSpeed(store.GetSlot(Dog::Id{1}), Speed{0, 0});
+            store.AdvanceTime(500);
+
+            THEN("its idle time starts from the stop") {
+                CHECK(CollectIdle(store, IDLE_LIMIT) == std::vector<uint64_t>{2});
+                CHECK(store.GetIdleTime(store.GetSlot(Dog::Id{1})) == 500);
+                CHECK(store.GetPlayTime(store.GetSlot(Dog::Id{1})) == 1000);
+
+                store.AdvanceTime(500);
+                CHECK(CollectIdle(store, IDLE_LIMIT) == std::vector<uint64_t>{1});
+            }
+        }
+
+        WHEN("a dog leaves before the limit") {
+            store.Remove(Dog::Id{2});
+            store.AdvanceTime(1000);
+
+            THEN("its stale timer is skipped") {
+                CHECK(CollectIdle(store, IDLE_LIMIT) == std::vector<uint64_t>{1});
+            }
+        }
+    }
+
+    GIVEN("a dog that often stops and starts") {
+        DogStore store;
+        const auto slot = store.Add(Dog::Id{1}, Position{});
+
+        for (int i = 0; i < 1000; ++i) {
+            store.SetSpeed(slot, Speed{1, 0});
+            store.AdvanceTime(1);
+            store.SetSpeed(slot, Speed{0, 0});
+        }
+
+        THEN("retirement still counts from the last stop") {
+            store.AdvanceTime(999);
+            CHECK(CollectIdle(store, IDLE_LIMIT).empty());
+            store.AdvanceTime(1);
+            CHECK(CollectIdle(store, IDLE_LIMIT) == std::vector<uint64_t>{1});
+        }
+    }
+
+    GIVEN("dogs owned by the store") {
+        DogStore store;
+        auto& first = store.AddDog(Dog::Id{1}, Position{1, 0}, "first", 1.0, 3);
+        auto& second = store.AddDog(Dog::Id{2}, Position{2, 0}, "second", 1.0, 3);
+        auto& third = store.AddDog(Dog::Id{3}, Position{3, 0}, "third", 1.0, 3);
+
+        WHEN("a dog from the middle leaves") {
+            store.Remove(Dog::Id{2});
+
+            THEN("the last dog moves to its slot and keeps its own state") {
+                CHECK(store.FindDog(Dog::Id{2}) == nullptr);
+                CHECK(store.FindDog(Dog::Id{3}) == &third);
+                CHECK(&store.GetDog(store.GetSlot(Dog::Id{3})) == &third);
+                CHECK(third.GetPos() == Position{3, 0});
+                CHECK(first.GetPos() == Position{1, 0});
+
+                third.SetPos(Position{5, 0});
+                CHECK(store.GetPos(store.GetSlot(Dog::Id{3})) == Position{5, 0});
+                CHECK(first.GetPos() == Position{1, 0});
+            }
+        }
+
+        THEN("each dog reads the hot state of its own slot") {
+            second.Action(model::MakeDogAction(2, "L"));
+            CHECK(store.GetSpeed(store.GetSlot(Dog::Id{2})).h_speed == -1.0);
+            CHECK(first.GetSpeed().h_speed == 0.0);
+            CHECK(second.GetDir() == model::Direction::WEST);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "model.h"
+
+using namespace std::literals;
+
+namespace {
+using namespace model;
+
+// roads горизонтальных дорог длиной 10 одна под другой
+std::shared_ptr<Map> MakeMap(const std::string& id, int roads) {
+    auto map = std::make_shared<Map>(Map::Id{id}, id, 1.0, 3, std::vector<int>{10});
+    for (int i = 0; i < roads; ++i) {
+        map->AddRoad(Road(Road::HORIZONTAL, Point{0, i * 10}, 10));
+    }
+    map->BuildRoadIndex();
+    return map;
+}
+
+loot_gen::LootGenerator MakeLootGenerator() {
+    // Лут не генерируется
+    return loot_gen::LootGenerator{std::chrono::milliseconds{1000}, 1.0, [] { return 0.0; }};
+}
+
+}  // namespace
+
+SCENARIO("Parallel game tick") {
+    constexpr int SESSIONS = 4;
+
+    GIVEN("a game with several sessions") {
+        Game game(MakeLootGenerator(), 1.0, 3, 60000, false);
+        for (int i = 0; i < SESSIONS; ++i) {
+            game.AddMap(MakeMap("map"s + std::to_string(i), 1));
+        }
+
+        WHEN("a dog runs in every session") {
+            std::vector<Dog*> dogs;
+            for (auto& [map_id, session] : game.GetSessions()) {
+                auto& dog = session.AddDog("dog");
+                session.PushAction(MakeDogAction(*dog.GetId(), "R"));
+                dogs.push_back(&dog);
+            }
+
+            int signals = 0;
+            game.DoTick([&signals](int64_t) {
+                ++signals;
+            });
+
+            // Шаг 0.5 представим точно, поэтому позицию можно сравнивать на равенство
+            constexpr int TICKS = 10;
+            for (int i = 0; i < TICKS; ++i) {
+                game.Tick(500);
+            }
+
+            THEN("each session is ticked exactly once per call") {
+                for (const auto* dog : dogs) {
+                    CHECK(dog->GetPos().x == 5.0);
+                    CHECK(dog->GetPlayTime() == TICKS * 500);
+                }
+                CHECK(signals == TICKS);
+            }
+        }
+
+        THEN("RunInSessions calls the function once for every session") {
+            std::map<const GameSession*, std::atomic<int>> calls;
+            for (const auto& [map_id, session] : game.GetSessions()) {
+                calls[&session] = 0;
+            }
+
+            for (int i = 0; i < 10; ++i) {
+                game.RunInSessions([&calls](GameSession& session) {
+                    ++calls.at(&session);
+                });
+            }
+
+            REQUIRE(calls.size() == SESSIONS);
+            for (const auto& [session, count] : calls) {
+                CHECK(count == 10);
+            }
+        }
+
+        THEN("an exception thrown in a session strand is rethrown to the caller") {
+            const GameSession* failing = &game.GetSession(Map::Id{"map2"});
+            std::atomic<int> finished = 0;
+
+            CHECK_THROWS_AS(game.RunInSessions([failing, &finished](GameSession& session) {
+                if (&session == failing) {
+                    throw std::runtime_error("session failed");
+                }
+                ++finished;
+            }), std::runtime_error);
+
+            // Исключение не мешает остальным сессиям и следующим тикам
+            CHECK(finished == SESSIONS - 1);
+            CHECK_NOTHROW(game.Tick(100));
+        }
+    }
+
+    GIVEN("sessions that pick random spawn points") {
+        Game game(MakeLootGenerator(), 1.0, 3, 60000, true);
+        for (int i = 0; i < SESSIONS; ++i) {
+            game.AddMap(MakeMap("map"s + std::to_string(i), 32));
+        }
+
+        std::map<const GameSession*, std::vector<Position>> spawns;
+        for (const auto& [map_id, session] : game.GetSessions()) {
+            spawns[&session];
+        }
+
+        // Собаки добавляются в strand сессий, то есть в разных потоках пула
+        game.RunInSessions([&spawns](GameSession& session) {
+            auto& positions = spawns.at(&session);
+            for (int i = 0; i < 16; ++i) {
+                positions.push_back(session.AddDog("dog").GetPos());
+            }
+        });
+
+        THEN("the thread-local generators are seeded independently") {
+            const auto& first = spawns.begin()->second;
+            bool differs = false;
+            for (const auto& [session, positions] : spawns) {
+                REQUIRE(positions.size() == 16);
+                differs = differs || positions != first;
+            }
+            CHECK(differs);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "leaderboard.h"
+
+using namespace std::literals;
+using app::Leaderboard;
+
+namespace {
+    DTO::Score MakeScore(int score, int play_time_ms, std::string name = "dog"s, std::string id = ""s) {
+        return DTO::Score{.name = std::move(name), .score = score, .play_time_ms = play_time_ms, .id = std::move(id)};
+    }
+
+    // Порядок выдачи /records: как ORDER BY -score, play_time_ms, name, id
+    void SortLikeDatabase(std::vector<DTO::Score>& scores) {
+        std::sort(scores.begin(), scores.end(), [](const DTO::Score& lhs, const DTO::Score& rhs) {
+            return std::tuple(-lhs.score, lhs.play_time_ms, lhs.name, lhs.id) < std::tuple(-rhs.score, rhs.play_time_ms, rhs.name, rhs.id);
+        });
+    }
+
+    std::vector<std::tuple<std::string, int64_t, int64_t, std::string>> Keys(const std::vector<DTO::Score>& scores) {
+        std::vector<std::tuple<std::string, int64_t, int64_t, std::string>> keys;
+        for (const auto& score : scores) {
+            keys.emplace_back(score.name, score.score, score.play_time_ms, score.id);
+        }
+        return keys;
+    }
+}
+
+SCENARIO("In-memory leaderboard") {
+    GIVEN("a database with fewer records than the cache holds") {
+        Leaderboard board{1};
+        std::vector<DTO::Score> db{MakeScore(30, 100, "a"s), MakeScore(20, 50, "b"s), MakeScore(20, 70, "c"s)};
+        board.Seed(db);
+
+        THEN("any page is served from memory") {
+            auto page = board.GetPage(2, 1);
+            REQUIRE(page.has_value());
+            CHECK(Keys(*page) == Keys({db[1], db[2]}));
+
+            auto beyond = board.GetPage(100, 500);
+            REQUIRE(beyond.has_value());
+            CHECK(beyond->empty());
+        }
+
+        WHEN("a new record is added") {
+            board.Add(MakeScore(20, 60, "d"s));
+
+            THEN("it takes its place in the order") {
+                auto page = board.GetPage(100, 0);
+                REQUIRE(page.has_value());
+                CHECK(Keys(*page) == Keys({db[0], db[1], MakeScore(20, 60, "d"s), db[2]}));
+            }
+        }
+
+        THEN("negative arguments are left to the database") {
+            CHECK_FALSE(board.GetPage(-1, 0).has_value());
+            CHECK_FALSE(board.GetPage(10, -1).has_value());
+        }
+    }
+
+    GIVEN("a full cache") {
+        Leaderboard board{1};
+        std::vector<DTO::Score> db;
+        for (int i = 0; i < 150; ++i) {
+            db.push_back(MakeScore(i % 37, i, "dog"s + std::to_string(i)));
+        }
+        SortLikeDatabase(db);
+        board.Seed({db.begin(), db.begin() + Leaderboard::PAGE_SIZE});
+
+        THEN("pages past the cached window go to the database") {
+            CHECK(board.GetPage(100, 0).has_value());
+            CHECK(board.GetPage(50, 50).has_value());
+            CHECK_FALSE(board.GetPage(10, 95).has_value());
+        }
+
+        WHEN("more records arrive") {
+            for (int i = 150; i < 400; ++i) {
+                auto score = MakeScore((i * 7) % 53, i, "dog"s + std::to_string(i));
+                db.push_back(score);
+                board.Add(score);
+            }
+            SortLikeDatabase(db);
+
+            THEN("the cache matches the top of the database") {
+                auto page = board.GetPage(100, 0);
+                REQUIRE(page.has_value());
+                CHECK(Keys(*page) == Keys({db.begin(), db.begin() + 100}));
+                CHECK_FALSE(board.GetPage(1, 100).has_value());
+            }
+        }
+    }
+
+    GIVEN("records that differ only by id") {
+        Leaderboard board{1};
+        std::vector<DTO::Score> db;
+        for (int i = 0; i < 150; ++i) {
+            db.push_back(MakeScore(i % 3, 0, "dog"s, std::to_string(1000 + i)));
+        }
+        SortLikeDatabase(db);
+        board.Seed({db.begin(), db.begin() + Leaderboard::PAGE_SIZE});
+
+        WHEN("the cached window is walked with cursors") {
+            std::vector<DTO::Score> walked;
+            auto page = board.GetPage(30, 0);
+            REQUIRE(page.has_value());
+            walked = std::move(*page);
+            for (int i = 0; i < 2; ++i) {
+                page = board.GetPageAfter(walked.back(), 30);
+                REQUIRE(page.has_value());
+                walked.insert(walked.end(), page->begin(), page->end());
+            }
+
+            THEN("every record is visited once and in order") {
+                CHECK(Keys(walked) == Keys({db.begin(), db.begin() + 90}));
+            }
+
+            THEN("a page crossing the end of the window goes to the database") {
+                CHECK_FALSE(board.GetPageAfter(walked.back(), 11).has_value());
+                CHECK(board.GetPageAfter(walked.back(), 10).has_value());
+            }
+        }
+    }
+
+    GIVEN("a cache with no pages") {
+        Leaderboard board{0};
+        board.Add(MakeScore(1, 1));
+
+        THEN("every non-empty page goes to the database") {
+            CHECK_FALSE(board.GetPage(1, 0).has_value());
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "local_store.h"
+
+using namespace std::literals;
+namespace fs = std::filesystem;
+
+namespace {
+    DTO::Score MakeScore(int i) {
+        return DTO::Score{
+            .name = "dog"s + std::to_string(i),
+            .score = i % 7,
+            .play_time_ms = i * 10,
+            .id = "00000000-0000-0000-0000-" + std::to_string(100000000000 + i)
+        };
+    }
+
+    // Файл журнала во временном каталоге, удаляется вместе с каталогом
+    struct TempLog {
+        TempLog()
+            : dir{fs::temp_directory_path() / ("score_log_test_"s + std::to_string(std::rand()))}
+            , path{dir / "scores.log"} {
+            fs::create_directories(dir);
+        }
+
+        ~TempLog() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+
+        fs::path dir;
+        fs::path path;
+    };
+
+    void Commit(postgres::LocalScoreStore& store, const std::vector<DTO::Score>& scores) {
+        auto uow = store.GetFactory().CreateUnitOfWork();
+        uow->GetScores().SaveBatch(scores);
+        uow->Commit();
+    }
+}
+
+SCENARIO("Local score store") {
+    GIVEN("a store in a new file") {
+        TempLog log;
+        std::vector<DTO::Score> all;
+        for (int i = 0; i < 50; ++i) {
+            all.push_back(MakeScore(i));
+        }
+        std::sort(all.begin(), all.end(), DTO::ScoreOrder{});
+
+        {
+            postgres::LocalScoreStore store{log.path};
+            Commit(store, {all.begin() + 25, all.end()});
+            Commit(store, {all.begin(), all.begin() + 25});
+
+            THEN("pages are served in records order") {
+                auto page = store.GetScores(10, 20);
+                REQUIRE(page.size() == 10);
+                CHECK(page.front().id == all[20].id);
+                CHECK(page.back().id == all[29].id);
+                CHECK(store.GetScores(100, 45).size() == 5);
+
+                auto after = store.GetScoresAfter(all[29], 5);
+                REQUIRE(after.size() == 5);
+                CHECK(after.front().id == all[30].id);
+            }
+
+            THEN("a rolled back transaction leaves no records") {
+                auto uow = store.GetFactory().CreateUnitOfWork();
+                uow->GetScores().Save(MakeScore(1000));
+                uow->RollBack();
+                CHECK(store.Size() == all.size());
+            }
+        }
+
+        WHEN("the file is reopened after a repeated batch and a torn write") {
+            {
+                postgres::LocalScoreStore store{log.path};
+                Commit(store, {all.begin(), all.begin() + 3});
+            }
+            {
+                std::ofstream ofs{log.path, std::ios::binary | std::ios::app};
+                ofs.write("\x24" "0000", 5);
+            }
+            const auto size_before = fs::file_size(log.path);
+
+            postgres::LocalScoreStore store{log.path};
+
+            THEN("duplicates and the torn tail are compacted away") {
+                CHECK(store.Size() == all.size());
+                CHECK(fs::file_size(log.path) < size_before);
+                auto page = store.GetScores(100, 0);
+                REQUIRE(page.size() == all.size());
+                for (size_t i = 0; i < all.size(); ++i) {
+                    CHECK(page[i].id == all[i].id);
+                    CHECK(page[i].name == all[i].name);
+                }
+            }
+
+            THEN("new records are appended after compaction") {
+                Commit(store, {MakeScore(1000)});
+                postgres::LocalScoreStore reopened{log.path};
+                CHECK(reopened.Size() == all.size() + 1);
+            }
+        }
+    }
+
+    GIVEN("a file that is not a score log") {
+        TempLog log;
+        {
+            std::ofstream ofs{log.path};
+            ofs << "important data";
+        }
+
+        THEN("the store refuses to open it and leaves it intact") {
+            CHECK_THROWS_AS(postgres::LocalScoreStore{log.path}, std::runtime_error);
+            CHECK(fs::file_size(log.path) == "important data"sv.size());
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "player_list.h"
+
+using namespace std::literals;
+using app::PlayerList;
+using app::PlayerView;
+
+namespace {
+    PlayerView MakePlayer(uint64_t dog_id) {
+        return PlayerView{.id = dog_id * 10, .dog_id = model::Dog::Id{dog_id}, .name = "dog"s + std::to_string(dog_id)};
+    }
+
+    std::vector<uint64_t> DogIds(const PlayerList& list) {
+        std::vector<uint64_t> ids;
+        for (const auto& player : list) {
+            ids.push_back(*player.dog_id);
+        }
+        return ids;
+    }
+}
+
+SCENARIO("Chunked session player list") {
+    GIVEN("players joining in dog id order") {
+        auto list = std::make_shared<const PlayerList>();
+        for (uint64_t id = 1; id <= 200; ++id) {
+            list = list->Insert(MakePlayer(id));
+        }
+
+        THEN("they are iterated in order and found by dog id") {
+            REQUIRE(list->size() == 200);
+            auto ids = DogIds(*list);
+            CHECK(std::is_sorted(ids.begin(), ids.end()));
+            REQUIRE(list->Find(model::Dog::Id{137}) != nullptr);
+            CHECK(list->Find(model::Dog::Id{137})->id == 1370);
+            CHECK(list->Find(model::Dog::Id{201}) == nullptr);
+        }
+
+        WHEN("a player leaves") {
+            auto updated = list->Erase(model::Dog::Id{100});
+
+            THEN("the old list is unchanged and the new one lacks the player") {
+                REQUIRE(updated != nullptr);
+                CHECK(list->Find(model::Dog::Id{100}) != nullptr);
+                CHECK(updated->Find(model::Dog::Id{100}) == nullptr);
+                CHECK(updated->size() == 199);
+                CHECK(updated->Erase(model::Dog::Id{100}) == nullptr);
+            }
+        }
+    }
+
+    GIVEN("random inserts and erases") {
+        std::mt19937 gen{7};
+        std::uniform_int_distribution<uint64_t> dog{1, 500};
+        std::map<uint64_t, PlayerView> expected;
+        auto list = std::make_shared<const PlayerList>();
+
+        for (int i = 0; i < 5000; ++i) {
+            const auto id = dog(gen);
+            if (i % 3 == 0) {
+                if (auto updated = list->Erase(model::Dog::Id{id})) {
+                    list = std::move(updated);
+                }
+                expected.erase(id);
+            } else {
+                list = list->Insert(MakePlayer(id));
+                expected.insert_or_assign(id, MakePlayer(id));
+            }
+        }
+
+        THEN("the list matches an ordered map") {
+            std::vector<uint64_t> ids;
+            for (const auto& [id, player] : expected) {
+                ids.push_back(id);
+            }
+            CHECK(list->size() == expected.size());
+            CHECK(DogIds(*list) == ids);
+            for (uint64_t id = 1; id <= 500; ++id) {
+                CHECK((list->Find(model::Dog::Id{id}) != nullptr) == expected.contains(id));
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "players.h"
+
+using namespace std::literals;
+
+namespace {
+    std::shared_ptr<model::Map> MakeMap(const std::string& id) {
+        auto map = std::make_shared<model::Map>(model::Map::Id{id}, id, 1.0, 3, std::vector<int>{10});
+        map->AddRoad(model::Road(model::Road::HORIZONTAL, model::Point{0, 0}, 40));
+        map->BuildRoadIndex();
+        return map;
+    }
+
+    std::set<app::Player::Id> PlayersInSession(const app::Players& players, const model::GameSession& session) {
+        std::set<app::Player::Id> ids;
+        players.ForEachInSession(&session, [&ids](const app::Player& player) {
+            CHECK(ids.insert(player.GetId()).second);
+        });
+        return ids;
+    }
+}
+
+SCENARIO("Per-session player index") {
+    GIVEN("players in two sessions") {
+        loot_gen::LootGenerator loot_gen{std::chrono::milliseconds{1000}, 1.0, [] { return 0.0; }};
+        model::Game game(loot_gen, 1.0, 3, 60000, false);
+        game.AddMap(MakeMap("first"));
+        game.AddMap(MakeMap("second"));
+        auto& first = game.GetSession(model::Map::Id{"first"});
+        auto& second = game.GetSession(model::Map::Id{"second"});
+
+        app::Players players;
+        std::vector<model::Dog*> first_dogs;
+        for (app::Player::Id id = 1; id <= 5; ++id) {
+            auto& dog = first.AddDog("dog"s + std::to_string(id));
+            first_dogs.push_back(&dog);
+            players.Add(first, dog, id);
+        }
+        players.Add(second, second.AddDog("other"), 100);
+
+        THEN("each session lists only its own players") {
+            CHECK(PlayersInSession(players, first) == std::set<app::Player::Id>{1, 2, 3, 4, 5});
+            CHECK(PlayersInSession(players, second) == std::set<app::Player::Id>{100});
+        }
+
+        WHEN("players leave from the middle, the end and the start of the index") {
+            const auto& map_id = first.GetMap()->GetId();
+            players.DeletePlayer(first_dogs[2]->GetId(), map_id);
+            players.DeletePlayer(first_dogs[4]->GetId(), map_id);
+            players.DeletePlayer(first_dogs[0]->GetId(), map_id);
+
+            THEN("the remaining players are still listed and found") {
+                CHECK(PlayersInSession(players, first) == std::set<app::Player::Id>{2, 4});
+                CHECK(players.FindByDogIdAndMapId(first_dogs[1]->GetId(), map_id)->GetId() == 2);
+                CHECK(players.FindByDogIdAndMapId(first_dogs[2]->GetId(), map_id) == nullptr);
+            }
+
+            AND_WHEN("the rest leave and a new player joins") {
+                players.DeletePlayer(first_dogs[1]->GetId(), map_id);
+                players.DeletePlayer(first_dogs[3]->GetId(), map_id);
+                players.Add(first, first.AddDog("late"), 6);
+
+                THEN("only the new player is listed") {
+                    CHECK(PlayersInSession(players, first) == std::set<app::Player::Id>{6});
+                    CHECK(PlayersInSession(players, second) == std::set<app::Player::Id>{100});
+                }
+            }
+        }
+    }
+}
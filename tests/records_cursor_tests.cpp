@@ -0,0 +1,52 @@
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "records_cursor.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+SCENARIO("Records pagination cursor") {
+    GIVEN("a record") {
+        DTO::Score score{
+            .name = "Rex, the dog"s,
+            .score = 42,
+            .play_time_ms = 12345,
+            .id = "0b3e7c8a-5d2f-4e61-9a7b-1c2d3e4f5a6b"s
+        };
+
+        WHEN("its cursor is encoded") {
+            auto cursor = records_cursor::Encode(score);
+
+            THEN("the cursor is safe in a query string and decodes to the same key") {
+                CHECK(cursor.find_first_not_of("0123456789abcdef"sv) == std::string::npos);
+
+                auto decoded = records_cursor::Decode(cursor);
+                REQUIRE(decoded.has_value());
+                CHECK(decoded->name == score.name);
+                CHECK(decoded->score == score.score);
+                CHECK(decoded->play_time_ms == score.play_time_ms);
+                CHECK(decoded->id == score.id);
+            }
+
+            THEN("a damaged cursor is rejected") {
+                CHECK_FALSE(records_cursor::Decode(""sv).has_value());
+                CHECK_FALSE(records_cursor::Decode(std::string_view(cursor).substr(1)).has_value());
+                CHECK_FALSE(records_cursor::Decode(cursor.substr(0, cursor.size() - 2) + "zz").has_value());
+            }
+        }
+
+        THEN("a cursor with a malformed id or number is rejected") {
+            auto bad_id = score;
+            bad_id.id = "'; DROP TABLE retired_players; --"s;
+            CHECK_FALSE(records_cursor::Decode(records_cursor::Encode(bad_id)).has_value());
+
+            // "4x,1,<id>,a"
+            auto bad_number = records_cursor::Encode(score);
+            bad_number.replace(2, 2, "78"s);
+            CHECK_FALSE(records_cursor::Decode(bad_number).has_value());
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "model.h"
+
+namespace {
+using model::Road;
+using model::Point;
+using model::Position;
+
+std::vector<size_t> BruteForceRoads(const std::vector<Road>& roads, Position pos) {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < roads.size(); ++i) {
+        if (roads[i].PointInArea(pos)) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> IndexedRoads(const std::vector<Road>& roads, const model::RoadIndex& index, Position pos) {
+    std::vector<size_t> result;
+    for (auto road_id : index.FindRoads(pos)) {
+        if (roads[road_id].PointInArea(pos)) {
+            result.push_back(road_id);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
+SCENARIO("Road index") {
+    GIVEN("an empty index") {
+        model::RoadIndex index;
+        index.Build({});
+
+        THEN("no roads are found") {
+            CHECK(index.FindRoads({0, 0}).empty());
+        }
+    }
+
+    GIVEN("a city grid of roads") {
+        std::vector<Road> roads;
+        for (int i = 0; i <= 100; i += 10) {
+            roads.emplace_back(Road::HORIZONTAL, Point{0, i}, 100);
+            roads.emplace_back(Road::VERTICAL, Point{i, 0}, 100);
+        }
+        roads.emplace_back(Road::HORIZONTAL, Point{95, 55}, 5);
+
+        model::RoadIndex index;
+        index.Build(roads);
+
+        WHEN("point lies on a road edge") {
+            const Position pos{100.4, 50.0};
+            THEN("index returns the same roads as brute force") {
+                CHECK(IndexedRoads(roads, index, pos) == BruteForceRoads(roads, pos));
+                CHECK_FALSE(IndexedRoads(roads, index, pos).empty());
+            }
+        }
+
+        WHEN("point lies outside of the map") {
+            THEN("no roads are found") {
+                CHECK(IndexedRoads(roads, index, {-5, -5}).empty());
+                CHECK(IndexedRoads(roads, index, {200, 200}).empty());
+            }
+        }
+
+        WHEN("points are random") {
+            std::mt19937 gen{42};
+            std::uniform_real_distribution<double> dist{-2.0, 102.0};
+            THEN("index returns the same roads as brute force") {
+                for (int i = 0; i < 10000; ++i) {
+                    Position pos{dist(gen), dist(gen)};
+                    // Часть точек выравниваем на оси дорог, чтобы чаще попадать в их площадь
+                    if (i % 2 == 0) {
+                        pos.y = std::round(pos.y / 10) * 10;
+                    }
+                    INFO("x: " << pos.x << ", y: " << pos.y);
+                    REQUIRE(IndexedRoads(roads, index, pos) == BruteForceRoads(roads, pos));
+                }
+            }
+        }
+    }
+}
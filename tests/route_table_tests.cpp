@@ -0,0 +1,85 @@
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "route_table.h"
+#include "query_string.h"
+
+using namespace std::literals;
+using namespace http_handler;
+
+// Таблица строится при компиляции, поэтому часть проверок можно сделать там же
+static_assert(routes::Match("/api/v1/game/state?since=3"sv).GetRoute() == Route::STATE);
+static_assert(routes::Match("/api/v1/maps/map1"sv).GetRoute() == Route::MAP_BY_ID);
+
+SCENARIO("API route table") {
+    GIVEN("request targets") {
+        WHEN("a target is an exact endpoint") {
+            THEN("every endpoint resolves to its own route") {
+                for (const auto& route : routes::EXACT_ROUTES) {
+                    auto match = routes::Match(route.path);
+                    CHECK(match.info == &route);
+                    CHECK(match.path == route.path);
+                    CHECK(match.query.empty());
+                }
+            }
+        }
+
+        WHEN("a target has a query string or a map id") {
+            auto records = routes::Match("/api/v1/game/records?start=10&maxItems=5"sv);
+            auto map = routes::Match("/api/v1/maps/map1?x=1"sv);
+
+            THEN("the query is split off and the map id is matched by prefix") {
+                CHECK(records.GetRoute() == Route::RECORDS);
+                CHECK(records.path == "/api/v1/game/records"sv);
+                CHECK(records.query == "start=10&maxItems=5"sv);
+                CHECK(map.GetRoute() == Route::MAP_BY_ID);
+                CHECK(map.path == "/api/v1/maps/map1"sv);
+            }
+        }
+
+        WHEN("a target is close to an endpoint but not equal") {
+            THEN("it is unknown") {
+                CHECK(routes::Match("/api/v1/game/recordsX"sv).GetRoute() == Route::UNKNOWN);
+                CHECK(routes::Match("/api/v1/maps/"sv).GetRoute() == Route::UNKNOWN);
+                CHECK(routes::Match("/api/v1/game/"sv).GetRoute() == Route::UNKNOWN);
+                CHECK(routes::Match(""sv).GetRoute() == Route::UNKNOWN);
+            }
+        }
+
+        WHEN("methods are checked") {
+            const auto& join = *routes::Match(Endpoints::JOIN_GAME).info;
+            const auto& state = *routes::Match(Endpoints::STATE).info;
+
+            THEN("only the listed verbs are allowed") {
+                CHECK(join.Allows(http::verb::post));
+                CHECK_FALSE(join.Allows(http::verb::get));
+                CHECK(join.allow == AllowedMethod::POST);
+                CHECK(state.Allows(http::verb::get));
+                CHECK(state.Allows(http::verb::head));
+                CHECK_FALSE(state.Allows(http::verb::post));
+            }
+        }
+    }
+}
+
+SCENARIO("Query string parsing") {
+    GIVEN("a query string") {
+        QueryString query{"start=10&flag&maxItems=5&start=20&empty="sv};
+
+        THEN("values are found by key, the last repeated key wins") {
+            CHECK(query.Find("maxItems"sv) == "5"sv);
+            CHECK(query.Find("start"sv) == "20"sv);
+            CHECK(query.Find("empty"sv) == ""sv);
+            CHECK_FALSE(query.Find("flag"sv).has_value());
+            CHECK_FALSE(query.Find("max"sv).has_value());
+        }
+
+        THEN("numbers must take the whole value") {
+            CHECK(QueryString::ParseNumber<int64_t>("-15"sv) == -15);
+            CHECK_FALSE(QueryString::ParseNumber<int64_t>("15abc"sv).has_value());
+            CHECK_FALSE(QueryString::ParseNumber<int64_t>(""sv).has_value());
+            CHECK_FALSE(QueryString::ParseNumber<uint64_t>("-1"sv).has_value());
+        }
+    }
+}
@@ -0,0 +1,208 @@
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "score_writer.h"
+
+using namespace std::literals;
+
+namespace {
+    // Запоминает пачки вместо записи в базу, может имитировать недоступную базу
+    // и рекорд, который база не принимает
+    class FakeUseCases : public postgres::UseCases {
+    public:
+        void AddScore(const DTO::Score& score) override {
+            AddScores({score});
+        }
+
+        void AddScores(const std::vector<DTO::Score>& scores) override {
+            std::lock_guard lock{mtx};
+            ++calls;
+            if (failures > 0) {
+                --failures;
+                throw std::runtime_error("database is unavailable");
+            }
+            for (const auto& score : scores) {
+                if (score.name == rejected_name) {
+                    throw std::runtime_error("value too long");
+                }
+            }
+            batches.push_back(scores);
+        }
+
+        std::vector<DTO::Score> GetScores(int, int) const override {
+            return {};
+        }
+
+        std::vector<DTO::Score> GetScoresAfter(const DTO::Score&, int) const override {
+            return {};
+        }
+
+        size_t BatchCount() {
+            std::lock_guard lock{mtx};
+            return batches.size();
+        }
+
+        int CallCount() {
+            std::lock_guard lock{mtx};
+            return calls;
+        }
+
+        std::mutex mtx;
+        std::vector<std::vector<DTO::Score>> batches;
+        int failures = 0;
+        int calls = 0;
+        std::string rejected_name;
+    };
+
+    DTO::Score MakeScore(int i) {
+        return DTO::Score{
+            .name = "dog"s + std::to_string(i),
+            .score = i,
+            .play_time_ms = i * 10,
+            .id = "00000000-0000-0000-0000-" + std::to_string(100000000000 + i)
+        };
+    }
+}
+
+SCENARIO("Write-behind score persistence") {
+    GIVEN("a writer with a long flush interval") {
+        FakeUseCases use_cases;
+        postgres::ScoreWriterSettings settings{
+            .flush_interval = 1h,
+            .max_batch_size = 10,
+            .max_queue_size = 100
+        };
+
+        WHEN("fewer scores than a batch are pushed") {
+            {
+                postgres::ScoreWriter writer{use_cases, settings};
+                for (int i = 0; i < 5; ++i) {
+                    writer.Push(MakeScore(i));
+                }
+
+                THEN("they wait in the queue until the writer stops") {
+                    CHECK(writer.GetQueueDepth() == 5);
+                    CHECK(use_cases.BatchCount() == 0);
+                }
+            }
+
+            THEN("stopping writes them as one batch") {
+                REQUIRE(use_cases.batches.size() == 1);
+                CHECK(use_cases.batches[0].size() == 5);
+                CHECK(use_cases.batches[0][4].name == "dog4"s);
+            }
+        }
+
+        WHEN("more scores than a batch are pushed") {
+            postgres::ScoreWriter writer{use_cases, settings};
+            for (int i = 0; i < 25; ++i) {
+                writer.Push(MakeScore(i));
+            }
+            for (int i = 0; i < 200 && use_cases.BatchCount() < 2; ++i) {
+                std::this_thread::sleep_for(5ms);
+            }
+
+            THEN("full batches are written without waiting for the interval") {
+                CHECK(use_cases.BatchCount() == 2);
+                CHECK(writer.GetQueueDepth() == 5);
+            }
+        }
+
+        WHEN("the queue is full") {
+            postgres::ScoreWriter writer{use_cases, postgres::ScoreWriterSettings{.flush_interval = 1h, .max_batch_size = 1000, .max_queue_size = 3}};
+            for (int i = 0; i < 3; ++i) {
+                REQUIRE(writer.Push(MakeScore(i)));
+            }
+
+            THEN("new scores are rejected instead of blocking") {
+                CHECK_FALSE(writer.Push(MakeScore(3)));
+                CHECK(writer.GetQueueDepth() == 3);
+            }
+        }
+    }
+
+    GIVEN("a database that is unavailable for one flush") {
+        FakeUseCases use_cases;
+        // Пачка и каждый из трёх рекордов по отдельности
+        use_cases.failures = 4;
+
+        WHEN("scores are flushed") {
+            {
+                postgres::ScoreWriter writer{use_cases, postgres::ScoreWriterSettings{.flush_interval = 5ms, .max_batch_size = 10, .retry_delay = 5ms}};
+                for (int i = 0; i < 3; ++i) {
+                    writer.Push(MakeScore(i));
+                }
+                for (int i = 0; i < 200 && use_cases.BatchCount() == 0; ++i) {
+                    std::this_thread::sleep_for(5ms);
+                }
+            }
+
+            THEN("the failed batch is retried in the same order") {
+                REQUIRE(use_cases.batches.size() == 1);
+                REQUIRE(use_cases.batches[0].size() == 3);
+                CHECK(use_cases.batches[0][0].name == "dog0"s);
+                CHECK(use_cases.failures == 0);
+            }
+        }
+    }
+
+    GIVEN("a database that stays unavailable") {
+        FakeUseCases use_cases;
+        use_cases.failures = 1000000;
+
+        WHEN("a full batch waits in the queue") {
+            postgres::ScoreWriter writer{use_cases, postgres::ScoreWriterSettings{
+                .flush_interval = 1ms,
+                .max_batch_size = 1,
+                .retry_delay = 50ms,
+                .max_retry_delay = 50ms
+            }};
+            writer.Push(MakeScore(0));
+            std::this_thread::sleep_for(200ms);
+
+            THEN("retries wait for the backoff instead of spinning") {
+                // Попытка - пачка и один рекорд отдельно, не чаще раза в 50 мс
+                CHECK(use_cases.CallCount() <= 16);
+                CHECK(writer.GetQueueDepth() == 1);
+            }
+        }
+    }
+
+    GIVEN("a score the database rejects") {
+        FakeUseCases use_cases;
+        use_cases.rejected_name = "dog1"s;
+
+        WHEN("it is flushed in a batch with other scores") {
+            // Обработчик вызывается из потока записи, но только до остановки writer
+            std::vector<std::string> reported;
+            {
+                postgres::ScoreWriter writer{use_cases, postgres::ScoreWriterSettings{.flush_interval = 1h, .max_batch_size = 10},
+                    [&reported](const std::vector<DTO::Score>& scores) {
+                        for (const auto& score : scores) {
+                            reported.push_back(score.name);
+                        }
+                    }};
+                for (int i = 0; i < 3; ++i) {
+                    writer.Push(MakeScore(i));
+                }
+            }
+
+            THEN("the other scores are saved one by one and the rejected one is dropped") {
+                REQUIRE(use_cases.batches.size() == 2);
+                CHECK(use_cases.batches[0].size() == 1);
+                CHECK(use_cases.batches[0][0].name == "dog0"s);
+                CHECK(use_cases.batches[1][0].name == "dog2"s);
+            }
+
+            THEN("only the saved scores are reported") {
+                CHECK(reported == std::vector<std::string>{"dog0"s, "dog2"s});
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "model.h"
+
+namespace {
+using namespace model;
+
+std::shared_ptr<Map> MakeMap() {
+    auto map = std::make_shared<Map>(Map::Id{"map"}, "Map", 1.0, 3, std::vector<int>{10});
+    map->AddRoad(Road(Road::HORIZONTAL, Point{0, 0}, 40));
+    map->BuildRoadIndex();
+    return map;
+}
+
+bool Contains(const std::vector<Dog::Id>& ids, uint64_t id) {
+    return std::find(ids.begin(), ids.end(), Dog::Id{id}) != ids.end();
+}
+
+}  // namespace
+
+SCENARIO("Session snapshots") {
+    GIVEN("a session with two dogs") {
+        // Лут не генерируется, чтобы изменения зависели только от собак
+        loot_gen::LootGenerator loot_gen{std::chrono::milliseconds{1000}, 1.0, [] { return 0.0; }};
+        Game game(loot_gen, 1.0, 3, 60000, false);
+        game.AddMap(MakeMap());
+        auto& session = game.GetSession(Map::Id{"map"});
+
+        auto& first = session.AddDog("first");
+        session.AddDog("second");
+        session.PublishSnapshot();
+
+        const auto joined = session.GetSnapshot();
+
+        THEN("the snapshot lists new dogs as changed") {
+            REQUIRE(joined->version == 1);
+            REQUIRE(joined->dogs.size() == 2);
+            REQUIRE(joined->history.size() == 1);
+            CHECK(Contains(joined->history.back()->changed_dogs, 1));
+            CHECK(Contains(joined->history.back()->changed_dogs, 2));
+        }
+
+        WHEN("one dog moves during a tick") {
+            session.PushAction(MakeDogAction(*first.GetId(), "R"));
+            game.Tick(1000);
+            const auto ticked = session.GetSnapshot();
+
+            THEN("only the moved dog is in the changes") {
+                REQUIRE(ticked->version == 2);
+                const auto& changes = *ticked->history.back();
+                CHECK(changes.changed_dogs == std::vector<Dog::Id>{Dog::Id{1}});
+                CHECK(changes.removed_dogs.empty());
+                CHECK(changes.added_loot.empty());
+                CHECK(ticked->FindDog(Dog::Id{1})->pos.x == 1.0);
+            }
+
+            THEN("the previous snapshot stays unchanged") {
+                CHECK(joined->version == 1);
+                CHECK(joined->FindDog(Dog::Id{1})->pos.x == 0.0);
+            }
+        }
+
+        WHEN("a dog leaves") {
+            session.DeleteDog(Dog::Id{2});
+            session.PublishSnapshot();
+
+            THEN("it is listed as removed") {
+                const auto& changes = *session.GetSnapshot()->history.back();
+                CHECK(changes.removed_dogs == std::vector<Dog::Id>{Dog::Id{2}});
+                CHECK(changes.changed_dogs.empty());
+            }
+        }
+
+        WHEN("a tick changes nothing") {
+            game.Tick(1000);
+
+            THEN("the previous snapshot is kept with its version") {
+                CHECK(session.GetSnapshot() == joined);
+            }
+        }
+
+        WHEN("a dog joins and leaves between two snapshots") {
+            auto& guest = session.AddDog("guest");
+            session.DeleteDog(guest.GetId());
+            session.PushAction(MakeDogAction(*first.GetId(), "R"));
+            game.Tick(1000);
+
+            THEN("it is neither in the snapshot nor in the changes") {
+                const auto ticked = session.GetSnapshot();
+                REQUIRE(ticked->version == 2);
+                CHECK(ticked->dogs.size() == 2);
+                CHECK(ticked->history.back()->changed_dogs == std::vector<Dog::Id>{Dog::Id{1}});
+                CHECK(ticked->history.back()->removed_dogs.empty());
+            }
+        }
+
+        WHEN("a dog joins after the snapshot") {
+            session.AddDog("third");
+            session.PublishSnapshot();
+
+            THEN("it is added in id order and the others are carried over") {
+                const auto snapshot = session.GetSnapshot();
+                REQUIRE(snapshot->dogs.size() == 3);
+                CHECK(snapshot->dogs[2].id == Dog::Id{3});
+                CHECK(snapshot->history.back()->changed_dogs == std::vector<Dog::Id>{Dog::Id{3}});
+                CHECK(snapshot->FindDog(Dog::Id{1})->pos == joined->FindDog(Dog::Id{1})->pos);
+            }
+        }
+
+        WHEN("many ticks pass") {
+            session.PushAction(MakeDogAction(*first.GetId(), "R"));
+            for (int i = 0; i < 100; ++i) {
+                game.Tick(10);
+            }
+
+            THEN("only the latest change sets are kept") {
+                const auto snapshot = session.GetSnapshot();
+                REQUIRE(!snapshot->history.empty());
+                CHECK(snapshot->history.size() == model::GameSession::CHANGES_HISTORY_SIZE);
+                CHECK(snapshot->history.back()->version == snapshot->version);
+                CHECK(snapshot->history.front()->version == snapshot->version - snapshot->history.size() + 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "state_broadcaster.h"
+#include "local_store.h"
+
+using namespace std::literals;
+
+namespace {
+    namespace fs = std::filesystem;
+    namespace json = boost::json;
+
+    using CloseCode = boost::beast::websocket::close_code;
+
+    // Запоминает отправленные сообщения и код закрытия вместо записи в поток
+    struct FakeSocket {
+        std::vector<std::shared_ptr<const std::string>> messages;
+        std::optional<CloseCode> close_code;
+
+        void Send(std::shared_ptr<const std::string> message) {
+            messages.push_back(std::move(message));
+        }
+
+        void Close(CloseCode code = CloseCode::normal) {
+            close_code = code;
+        }
+    };
+
+    using Broadcaster = http_handler::StateBroadcaster<FakeSocket>;
+
+    std::shared_ptr<model::Map> MakeMap() {
+        auto map = std::make_shared<model::Map>(model::Map::Id{"map"}, "map", 1.0, 3, std::vector<int>{10});
+        map->AddRoad(model::Road(model::Road::HORIZONTAL, model::Point{0, 0}, 40));
+        map->BuildRoadIndex();
+        return map;
+    }
+
+    // Журнал рекордов во временном каталоге, удаляется вместе с каталогом
+    struct TempLog {
+        TempLog()
+            : dir{fs::temp_directory_path() / ("state_broadcaster_test_"s + std::to_string(std::rand()))}
+            , path{dir / "scores.log"} {
+            fs::create_directories(dir);
+        }
+
+        ~TempLog() {
+            std::error_code ec;
+            fs::remove_all(dir, ec);
+        }
+
+        fs::path dir;
+        fs::path path;
+    };
+
+    app::TokenKey Key(const app::Token& token) {
+        return *app::TokenKey::Parse(token);
+    }
+
+    json::object Parse(const std::shared_ptr<const std::string>& message) {
+        return json::parse(*message).as_object();
+    }
+}
+
+SCENARIO("WebSocket state broadcast") {
+    GIVEN("a session with players subscribed to the broadcast") {
+        constexpr int64_t RETIREMENT_MS = 1000;
+        loot_gen::LootGenerator loot_gen{std::chrono::milliseconds{1000}, 0.0, [] { return 0.0; }};
+        model::Game game(loot_gen, 1.0, 3, RETIREMENT_MS, false);
+        game.AddMap(MakeMap());
+        auto& session = game.GetSession(model::Map::Id{"map"});
+
+        TempLog log;
+        postgres::LocalScoreStore store{log.path};
+        app::Application app{store.GetFactory(), postgres::ScoreWriterSettings{}, 0};
+        session.DoExit([&app](const std::vector<DTO::ExitPlayer>& exit_players) {
+            app.ExitPlayer(exit_players);
+        });
+
+        const auto join = [&app, &session](const std::string& name) {
+            auto& dog = session.AddDog(name);
+            auto token = app.AddPlayer(session, dog).first;
+            session.PublishSnapshot();
+            return Key(token);
+        };
+        const auto subscribe = [&app](Broadcaster& broadcaster, app::TokenKey token) {
+            auto socket = std::make_shared<FakeSocket>();
+            broadcaster.Subscribe(*app.FindSessionViewByToken(token), socket, token);
+            return socket;
+        };
+
+        Broadcaster broadcaster{game, app};
+        const auto runner = join("runner");
+        const auto watcher = join("watcher");
+
+        WHEN("subscribers are on the same version and on an older one") {
+            auto first = subscribe(broadcaster, runner);
+            auto second = subscribe(broadcaster, watcher);
+
+            REQUIRE(app.PushPlayerAction(runner, "R"sv));
+            game.Tick(100);
+            auto late = subscribe(broadcaster, watcher);
+            REQUIRE(app.PushPlayerAction(runner, "L"sv));
+            game.Tick(100);
+
+            broadcaster.Broadcast();
+
+            THEN("subscribers on the same version get one shared delta") {
+                REQUIRE(first->messages.size() == 2);
+                REQUIRE(second->messages.size() == 2);
+                CHECK(first->messages.back() == second->messages.back());
+                CHECK(Parse(first->messages.back()).at("tick").to_number<uint64_t>() == session.GetSnapshot()->version);
+            }
+
+            THEN("a subscriber on another version gets its own delta") {
+                REQUIRE(late->messages.size() == 2);
+                CHECK(late->messages.back() != first->messages.back());
+                CHECK(Parse(late->messages.back()).at("tick").to_number<uint64_t>() == session.GetSnapshot()->version);
+            }
+
+            THEN("nothing is sent until the version changes again") {
+                broadcaster.Broadcast();
+                CHECK(first->messages.size() == 2);
+                CHECK(late->messages.size() == 2);
+                CHECK_FALSE(first->close_code.has_value());
+            }
+        }
+
+        WHEN("a player times out") {
+            auto runner_socket = subscribe(broadcaster, runner);
+            auto watcher_socket = subscribe(broadcaster, watcher);
+
+            // Бегущая собака не простаивает, стоящая уходит по таймауту
+            for (int i = 0; i < 4; ++i) {
+                REQUIRE(app.PushPlayerAction(runner, i % 2 == 0 ? "R"sv : "L"sv));
+                game.Tick(RETIREMENT_MS / 2);
+            }
+            REQUIRE(app.FindSessionByToken(watcher) == nullptr);
+
+            broadcaster.Broadcast();
+
+            THEN("it gets the last delta and is closed with policy_error") {
+                REQUIRE(watcher_socket->messages.size() == 2);
+                CHECK(watcher_socket->close_code == CloseCode::policy_error);
+            }
+
+            THEN("it is no longer broadcast to, the others still are") {
+                CHECK_FALSE(runner_socket->close_code.has_value());
+
+                REQUIRE(app.PushPlayerAction(runner, "R"sv));
+                game.Tick(100);
+                broadcaster.Broadcast();
+                CHECK(runner_socket->messages.size() == 3);
+                CHECK(watcher_socket->messages.size() == 2);
+            }
+        }
+    }
+}
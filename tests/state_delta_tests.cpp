@@ -0,0 +1,122 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "state_delta.h"
+
+using namespace std::literals;
+
+namespace {
+    using app::Application;
+
+    model::DogSnapshot MakeDog(uint64_t id, double x) {
+        return model::DogSnapshot{.id = model::Dog::Id{id}, .pos = {x, 0.0}};
+    }
+
+    std::shared_ptr<const model::SessionChanges> MakeChanges(uint64_t version, std::vector<uint64_t> changed, std::vector<uint64_t> removed,
+                                                             std::vector<int> added_loot = {}, std::vector<int> removed_loot = {}) {
+        auto changes = std::make_shared<model::SessionChanges>();
+        changes->version = version;
+        for (auto id : changed) {
+            changes->changed_dogs.push_back(model::Dog::Id{id});
+        }
+        for (auto id : removed) {
+            changes->removed_dogs.push_back(model::Dog::Id{id});
+        }
+        changes->added_loot = std::move(added_loot);
+        changes->removed_loot = std::move(removed_loot);
+        return changes;
+    }
+
+    std::shared_ptr<const Application::SessionPlayers> MakePlayers(const std::vector<std::pair<app::Player::Id, uint64_t>>& players) {
+        auto list = std::make_shared<const Application::SessionPlayers>();
+        for (const auto& [player_id, dog_id] : players) {
+            list = list->Insert({player_id, model::Dog::Id{dog_id}, "player"s + std::to_string(player_id)});
+        }
+        return list;
+    }
+
+    /*
+     * Снимок версии 3 после двух наборов изменений:
+     * v2 - собака 1 сдвинулась, появился лут 10;
+     * v3 - собака 2 ушла из сессии, лут 10 подобран, появился лут 11, вошла собака 3
+     */
+    Application::SessionView MakeView() {
+        auto snapshot = std::make_shared<model::SessionSnapshot>();
+        snapshot->version = 3;
+        snapshot->dogs = {MakeDog(1, 5.0), MakeDog(3, 0.0)};
+        snapshot->loot_in_map = {model::Loot{.id = 11, .type = 0, .pos = {1.0, 0.0}}};
+        snapshot->history = {
+            MakeChanges(2, {1}, {}, {10}, {}),
+            MakeChanges(3, {3}, {2}, {11}, {10})
+        };
+
+        return Application::SessionView{
+            .snapshot = std::move(snapshot),
+            .players = MakePlayers({{100, 1}, {300, 3}}),
+            .departed = MakePlayers({{200, 2}})
+        };
+    }
+
+    std::vector<app::Player::Id> PlayerIds(const http_handler::StateDelta& delta) {
+        std::vector<app::Player::Id> ids;
+        for (const auto& player : delta.players) {
+            ids.push_back(player.id);
+        }
+        return ids;
+    }
+}
+
+SCENARIO("State delta collection") {
+    GIVEN("a snapshot with two change sets") {
+        const auto view = MakeView();
+
+        THEN("changes after the oldest known version are merged") {
+            auto delta = http_handler::CollectStateDelta(view, 1);
+            REQUIRE(delta.has_value());
+            CHECK(PlayerIds(*delta) == std::vector<app::Player::Id>{100, 300});
+            CHECK(delta->players[0].dog == view.snapshot->FindDog(model::Dog::Id{1}));
+            CHECK(delta->removed_players == std::vector<app::Player::Id>{200});
+            REQUIRE(delta->loot.size() == 1);
+            CHECK(delta->loot[0]->id == 11);
+            CHECK(delta->removed_loot == std::vector<int>{10});
+        }
+
+        THEN("only the newer change set is used after version 2") {
+            auto delta = http_handler::CollectStateDelta(view, 2);
+            REQUIRE(delta.has_value());
+            CHECK(PlayerIds(*delta) == std::vector<app::Player::Id>{300});
+            CHECK(delta->removed_players == std::vector<app::Player::Id>{200});
+        }
+
+        THEN("the current version yields an empty delta") {
+            auto delta = http_handler::CollectStateDelta(view, 3);
+            REQUIRE(delta.has_value());
+            CHECK(delta->players.empty());
+            CHECK(delta->removed_players.empty());
+            CHECK(delta->loot.empty());
+            CHECK(delta->removed_loot.empty());
+        }
+
+        THEN("since=0, a future version or a version older than the history ask for the full state") {
+            CHECK_FALSE(http_handler::CollectStateDelta(view, 0).has_value());
+            CHECK_FALSE(http_handler::CollectStateDelta(view, 4).has_value());
+
+            auto trimmed = view;
+            auto snapshot = std::make_shared<model::SessionSnapshot>(*view.snapshot);
+            snapshot->history.erase(snapshot->history.begin());
+            trimmed.snapshot = std::move(snapshot);
+            CHECK_FALSE(http_handler::CollectStateDelta(trimmed, 1).has_value());
+            CHECK(http_handler::CollectStateDelta(trimmed, 2).has_value());
+        }
+
+        THEN("a changed dog without a player ever seen asks for the full state") {
+            auto unknown = view;
+            unknown.departed = std::make_shared<const Application::SessionPlayers>();
+            CHECK_FALSE(http_handler::CollectStateDelta(unknown, 2).has_value());
+        }
+    }
+}
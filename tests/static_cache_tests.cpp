@@ -0,0 +1,55 @@
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "static_cache.h"
+
+using namespace std::literals;
+using http_handler::StaticCache;
+
+SCENARIO("Static file paths") {
+    THEN("the root and an empty target map to index.html") {
+        CHECK(StaticCache::NormalizeTarget("/"sv) == "/index.html"s);
+        CHECK(StaticCache::NormalizeTarget(""sv) == "/index.html"s);
+        CHECK(StaticCache::NormalizeTarget("/?lang=ru"sv) == "/index.html"s);
+    }
+
+    THEN("the query string is not part of the path") {
+        CHECK(StaticCache::NormalizeTarget("/js/app.js?v=2"sv) == "/js/app.js"s);
+        CHECK(StaticCache::NormalizeTarget("/images/dog.png"sv) == "/images/dog.png"s);
+    }
+
+    THEN("dot segments inside the root are resolved") {
+        CHECK(StaticCache::NormalizeTarget("/js/../index.html"sv) == "/index.html"s);
+        CHECK(StaticCache::NormalizeTarget("/./js/./app.js"sv) == "/js/app.js"s);
+    }
+
+    THEN("a path leaving the root is rejected") {
+        CHECK_THROWS_AS(StaticCache::NormalizeTarget("/../etc/passwd"sv), std::runtime_error);
+        CHECK_THROWS_AS(StaticCache::NormalizeTarget("/js/../../etc/passwd"sv), std::runtime_error);
+        CHECK_THROWS_AS(StaticCache::NormalizeTarget("/.."sv), std::runtime_error);
+    }
+}
+
+SCENARIO("HTTP dates") {
+    // Пример из RFC 9110
+    const auto time = std::chrono::system_clock::from_time_t(784111777);
+    const auto text = "Sun, 06 Nov 1994 08:49:37 GMT"s;
+
+    THEN("a time is formatted as IMF-fixdate and parsed back") {
+        CHECK(http_handler::FormatHttpDate(time) == text);
+        CHECK(http_handler::ParseHttpDate(text) == time);
+    }
+
+    THEN("the current time round-trips with second precision") {
+        const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+        CHECK(http_handler::ParseHttpDate(http_handler::FormatHttpDate(now)) == now);
+    }
+
+    THEN("a malformed date is rejected") {
+        CHECK_FALSE(http_handler::ParseHttpDate("yesterday"sv).has_value());
+        CHECK_FALSE(http_handler::ParseHttpDate(""sv).has_value());
+    }
+}
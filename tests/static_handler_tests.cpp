@@ -0,0 +1,133 @@
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "static_handler.h"
+
+using namespace std::literals;
+using http_handler::detail::ByteRange;
+
+namespace {
+    namespace http = http_handler::http;
+
+    http_handler::StaticAsset MakeAsset(uintmax_t size) {
+        http_handler::StaticAsset asset;
+        asset.size = size;
+        asset.etag = "\"etag\""s;
+        asset.last_modified = "Sun, 06 Nov 1994 08:49:37 GMT"s;
+        return asset;
+    }
+
+    std::optional<ByteRange> GetRange(std::string_view range, const http_handler::StaticAsset& asset, std::string_view if_range = {}) {
+        http_handler::StringRequest req{http::verb::get, "/file.bin"sv, 11};
+        req.set(http::field::range, range);
+        if (!if_range.empty()) {
+            req.set(http::field::if_range, if_range);
+        }
+        return http_handler::detail::GetRange(req, asset);
+    }
+}
+
+SCENARIO("Range header parsing") {
+    GIVEN("a file of 100 bytes") {
+        const auto asset = MakeAsset(100);
+
+        THEN("bytes=a-b selects the closed range and is clipped to the file") {
+            auto range = GetRange("bytes=10-19"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->offset == 10);
+            CHECK(range->length == 10);
+
+            range = GetRange("bytes=90-1000"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->offset == 90);
+            CHECK(range->length == 10);
+        }
+
+        THEN("bytes=a- selects the rest of the file") {
+            auto range = GetRange("bytes=95-"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->offset == 95);
+            CHECK(range->length == 5);
+        }
+
+        THEN("bytes=-n selects the last n bytes") {
+            auto range = GetRange("bytes=-10"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->offset == 90);
+            CHECK(range->length == 10);
+
+            range = GetRange("bytes=-1000"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->offset == 0);
+            CHECK(range->length == 100);
+        }
+
+        THEN("bytes=-0 and an offset past the end are not satisfiable") {
+            auto range = GetRange("bytes=-0"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->length == 0);
+
+            range = GetRange("bytes=100-"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->length == 0);
+
+            range = GetRange("bytes=150-200"sv, asset);
+            REQUIRE(range.has_value());
+            CHECK(range->length == 0);
+        }
+
+        THEN("reversed, malformed and multiple ranges are ignored") {
+            CHECK_FALSE(GetRange("bytes=20-10"sv, asset).has_value());
+            CHECK_FALSE(GetRange("bytes=0-1,5-6"sv, asset).has_value());
+            CHECK_FALSE(GetRange("bytes=abc"sv, asset).has_value());
+            CHECK_FALSE(GetRange("items=0-1"sv, asset).has_value());
+        }
+
+        THEN("If-Range keeps the range only for the same version of the file") {
+            CHECK(GetRange("bytes=0-9"sv, asset, "\"etag\""sv).has_value());
+            CHECK(GetRange("bytes=0-9"sv, asset, "Sun, 06 Nov 1994 08:49:37 GMT"sv).has_value());
+            CHECK_FALSE(GetRange("bytes=0-9"sv, asset, "\"other\""sv).has_value());
+            CHECK_FALSE(GetRange("bytes=0-9"sv, asset, "Mon, 07 Nov 1994 08:49:37 GMT"sv).has_value());
+        }
+
+        THEN("Content-Range names the last byte of the range") {
+            CHECK(http_handler::detail::MakeContentRange(10, 10, 100) == "bytes 10-19/100"s);
+            CHECK(http_handler::detail::MakeContentRange(99, 1, 100) == "bytes 99-99/100"s);
+        }
+    }
+
+    GIVEN("a request without Range") {
+        http_handler::StringRequest req{http::verb::get, "/file.bin"sv, 11};
+
+        THEN("the whole file is sent") {
+            CHECK_FALSE(http_handler::detail::GetRange(req, MakeAsset(100)).has_value());
+        }
+    }
+}
+
+SCENARIO("gzip negotiation") {
+    auto accepts = [](std::string_view accept_encoding) {
+        http_handler::StringRequest req{http::verb::get, "/index.html"sv, 11};
+        req.set(http::field::accept_encoding, accept_encoding);
+        return http_handler::detail::AcceptsGzip(req);
+    };
+
+    THEN("gzip and * are accepted unless their q is zero") {
+        CHECK(accepts("gzip"sv));
+        CHECK(accepts("deflate, gzip;q=0.5"sv));
+        CHECK(accepts(" gzip ; q=1 , br"sv));
+        CHECK(accepts("*"sv));
+        CHECK_FALSE(accepts("gzip;q=0"sv));
+        CHECK_FALSE(accepts("br, *;q=0"sv));
+        CHECK_FALSE(accepts("deflate, br"sv));
+        CHECK_FALSE(accepts("x-gzip"sv));
+    }
+
+    THEN("a request without Accept-Encoding gets the plain body") {
+        http_handler::StringRequest req{http::verb::get, "/index.html"sv, 11};
+        CHECK_FALSE(http_handler::detail::AcceptsGzip(req));
+    }
+}
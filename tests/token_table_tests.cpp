@@ -0,0 +1,70 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "token_table.h"
+
+using namespace std::literals;
+using app::TokenKey;
+using app::TokenTable;
+
+SCENARIO("Token keys") {
+    GIVEN("a hex token") {
+        constexpr auto hex = "0123456789ABCDEF00000000000000FF"sv;
+
+        WHEN("it is parsed") {
+            auto key = TokenKey::Parse(hex);
+
+            THEN("the halves are read in order and the text round-trips") {
+                REQUIRE(key.has_value());
+                CHECK(key->high == 0x0123456789ABCDEFull);
+                CHECK(key->low == 0xFFull);
+                CHECK(key->ToString() == hex);
+            }
+        }
+
+        THEN("wrong length or non-hex characters are rejected") {
+            CHECK_FALSE(TokenKey::Parse(hex.substr(1)).has_value());
+            CHECK_FALSE(TokenKey::Parse("0123456789ABCDEF00000000000000FG"sv).has_value());
+            CHECK_FALSE(TokenKey::Parse("0123456789abcdef00000000000000ff"sv).has_value());
+            CHECK_FALSE(TokenKey::Parse(""sv).has_value());
+        }
+    }
+}
+
+SCENARIO("Open addressing token table") {
+    GIVEN("a table with many keys") {
+        TokenTable<int> table;
+        std::vector<TokenKey> keys;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            keys.push_back(TokenKey{.high = i * 7, .low = i});
+            REQUIRE(table.Insert(keys.back(), static_cast<int>(i)));
+        }
+
+        THEN("every key is found and duplicates are not inserted") {
+            CHECK(table.Size() == keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                REQUIRE(table.Find(keys[i]) != nullptr);
+                CHECK(*table.Find(keys[i]) == static_cast<int>(i));
+            }
+            CHECK_FALSE(table.Insert(keys.front(), -1));
+            CHECK(table.Find(TokenKey{.high = 1, .low = 1}) == nullptr);
+        }
+
+        WHEN("every other key is erased") {
+            for (size_t i = 0; i < keys.size(); i += 2) {
+                REQUIRE(table.Erase(keys[i]));
+            }
+
+            THEN("the remaining keys are still reachable") {
+                CHECK(table.Size() == keys.size() / 2);
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    CHECK(table.Contains(keys[i]) == (i % 2 == 1));
+                }
+                CHECK_FALSE(table.Erase(keys[0]));
+            }
+        }
+    }
+}